@@ -11,13 +11,156 @@
  */
 
 #include "WiFiManager.h"
+#include <errno.h>
+#include <limits.h>
 
 #if defined(ESP8266) || defined(ESP32)
 
 #ifdef ESP32
 uint8_t WiFiManager::_lastconxresulttmp = WL_IDLE_STATUS;
+RTC_NOINIT_ATTR static wm_rtc_t wm_rtcmem; // rtc cache, kept over deep sleep and soft resets
+#else
+static_assert(sizeof(wm_rtc_t) % 4 == 0 && sizeof(wm_rtc_t) <= 512 - WM_RTC_OFFSET*4, "wm_rtc_t does not fit rtc user memory");
 #endif
 
+// flash store record header
+typedef struct {
+  uint32_t crc;   // crc32 of data
+  uint16_t magic; // WM_STORE_MAGIC
+  uint16_t ver;   // caller record version
+  uint32_t len;   // data length
+} wm_store_hdr_t;
+
+// crc32 (ieee), integrity check for rtc and flash records
+static uint32_t wm_crc32(const void *data, size_t len){
+  const uint8_t *p = (const uint8_t*)data;
+  uint32_t crc = 0xFFFFFFFF;
+  while(len--){
+    crc ^= *p++;
+    for(uint8_t i=0; i<8; i++) crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+  }
+  return ~crc;
+}
+
+// json string escape, /api/config
+static String wm_json_escape(const String &str){
+  String out;
+  out.reserve(str.length());
+  for(size_t i=0; i<str.length(); i++){
+    char c = str[i];
+    if(c == '"' || c == '\\'){ out += '\\'; out += c; }
+    else if((uint8_t)c < 0x20){
+      char hex[7];
+      snprintf(hex, 7, "\\u%04x", (unsigned int)(uint8_t)c);
+      out += hex;
+    }
+    else out += c;
+  }
+  return out;
+}
+
+static void wm_json_ws(const char *&p){
+  while(*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') p++;
+}
+
+// json string, escapes and \u0000-\uffff as utf-8
+static bool wm_json_string(const char *&p, String &out){
+  if(*p++ != '"') return false;
+  while(*p && *p != '"'){
+    char c = *p++;
+    if(c == '\\'){
+      c = *p++;
+      switch(c){
+        case 'n': c = '\n'; break;
+        case 't': c = '\t'; break;
+        case 'r': c = '\r'; break;
+        case 'b': c = '\b'; break;
+        case 'f': c = '\f'; break;
+        case '"': case '\\': case '/': break;
+        case 'u': {
+          char hex[5] = {0};
+          for(uint8_t i=0; i<4; i++){
+            if(!isxdigit(*p)) return false;
+            hex[i] = *p++;
+          }
+          uint16_t u = strtoul(hex, NULL, 16);
+          if(u < 0x80) out += (char)u;
+          else if(u < 0x800){
+            out += (char)(0xC0 | (u >> 6));
+            out += (char)(0x80 | (u & 0x3F));
+          }
+          else {
+            out += (char)(0xE0 | (u >> 12));
+            out += (char)(0x80 | ((u >> 6) & 0x3F));
+            out += (char)(0x80 | (u & 0x3F));
+          }
+          continue;
+        }
+        default: return false;
+      }
+    }
+    out += c;
+  }
+  if(*p != '"') return false;
+  p++;
+  return true;
+}
+
+// minimal json object reader, /api/config
+// nested objects flatten to dotted keys, leaf values as text (numbers, true/false, null as ""), no arrays
+static bool wm_json_object(const char *&p, const String &prefix, const std::function<bool(const String &key, const String &value)> &leaf, uint8_t depth = 0){
+  wm_json_ws(p);
+  if(*p != '{' || depth > 2) return false;
+  p++;
+  wm_json_ws(p);
+  if(*p == '}'){
+    p++;
+    return true;
+  }
+  while(true){
+    String key;
+    wm_json_ws(p);
+    if(!wm_json_string(p, key)) return false;
+    wm_json_ws(p);
+    if(*p++ != ':') return false;
+    wm_json_ws(p);
+    key = prefix + key;
+    if(*p == '{'){
+      if(!wm_json_object(p, key + '.', leaf, depth + 1)) return false;
+    }
+    else {
+      String value;
+      if(*p == '"'){
+        if(!wm_json_string(p, value)) return false;
+      }
+      else {
+        while(*p && *p != ',' && *p != '}' && !isspace(*p)) value += *p++;
+        if(value == "" || value[0] == '[') return false;
+        if(value == F("null")) value = "";
+      }
+      if(!leaf(key, value)) return false;
+    }
+    wm_json_ws(p);
+    if(*p == ','){
+      p++;
+      continue;
+    }
+    if(*p != '}') return false;
+    p++;
+    return true;
+  }
+}
+
+// fnv-1a 32, parameter store record keys from ids
+static uint32_t wm_fnv1a(const char *str){
+  uint32_t hash = 0x811C9DC5;
+  while(*str){
+    hash ^= (uint8_t)*str++;
+    hash *= 0x01000193;
+  }
+  return hash;
+}
+
 /**
  * --------------------------------------------------------------------------------
  *  WiFiManagerParameter
@@ -41,6 +184,15 @@ WiFiManagerParameter::WiFiManagerParameter(const char *id, const char *label) {
   init(id, label, "", 0, "", WFM_LABEL_DEFAULT);
 }
 
+WiFiManagerParameter::WiFiManagerParameter(const __FlashStringHelper *custom) : WiFiManagerParameter((const char*)custom) {
+  _progmem = WM_PARAM_PGM_CUSTOM;
+}
+
+WiFiManagerParameter::WiFiManagerParameter(const char *id, const __FlashStringHelper *label, const char *defaultValue, int length, const __FlashStringHelper *custom, int labelPlacement) {
+  init(id, (const char*)label, defaultValue, length, custom ? (const char*)custom : "", labelPlacement);
+  _progmem = WM_PARAM_PGM_LABEL | (custom ? WM_PARAM_PGM_CUSTOM : 0);
+}
+
 WiFiManagerParameter::WiFiManagerParameter(const char *id, const char *label, const char *defaultValue, int length) {
   init(id, label, defaultValue, length, "", WFM_LABEL_DEFAULT);
 }
@@ -53,6 +205,15 @@ WiFiManagerParameter::WiFiManagerParameter(const char *id, const char *label, co
   init(id, label, defaultValue, length, custom, labelPlacement);
 }
 
+WiFiManagerParameter::WiFiManagerParameter(const char *id, const char *label, int length, const char *custom, int labelPlacement) {
+  _id             = id;
+  _label          = label;
+  _length         = length;
+  _value          = nullptr;
+  _labelPlacement = labelPlacement;
+  _customHTML     = custom;
+}
+
 void WiFiManagerParameter::init(const char *id, const char *label, const char *defaultValue, int length, const char *custom, int labelPlacement) {
   _id             = id;
   _label          = label;
@@ -64,18 +225,46 @@ void WiFiManagerParameter::init(const char *id, const char *label, const char *d
 }
 
 WiFiManagerParameter::~WiFiManagerParameter() {
-  if (_value != NULL) {
+  if (_value != NULL && _ownsValue) {
     delete[] _value;
   }
   _length=0; // setting length 0, ideally the entire parameter should be removed, or added to wifimanager scope so it follows
+  _magic=0;  // out of scope, see WiFiManager::paramValid
+}
+
+WiFiManagerParameter::WiFiManagerParameter(WiFiManagerParameter &&other) {
+  _id             = other._id;
+  _label          = other._label;
+  _length         = other._length;
+  _value          = other._value;
+  _ownsValue      = other._ownsValue;
+  _labelPlacement = other._labelPlacement;
+  _customHTML     = other._customHTML;
+  _section        = other._section;
+  _progmem        = other._progmem;
+  _validator      = std::move(other._validator);
+  _changedcallback = std::move(other._changedcallback);
+  if(_ownsValue) other._value = nullptr; // value buffer moves with us
+}
+
+WiFiManagerParameter& WiFiManagerParameter::operator=(WiFiManagerParameter &&other) {
+  if(this == &other) return *this;
+  if(_value != NULL && _ownsValue) delete[] _value;
+  _id             = other._id;
+  _label          = other._label;
+  _length         = other._length;
+  _value          = other._value;
+  _ownsValue      = other._ownsValue;
+  _labelPlacement = other._labelPlacement;
+  _customHTML     = other._customHTML;
+  _section        = other._section;
+  _progmem        = other._progmem;
+  _validator      = std::move(other._validator);
+  _changedcallback = std::move(other._changedcallback);
+  if(_ownsValue) other._value = nullptr;
+  return *this;
 }
 
-// WiFiManagerParameter& WiFiManagerParameter::operator=(const WiFiManagerParameter& rhs){
-//   Serial.println("copy assignment op called");
-//   (*this->_value) = (*rhs._value);
-//   return *this;
-// }
-
 // @note debug is not available in wmparameter class
 void WiFiManagerParameter::setValue(const char *defaultValue, int length) {
   if(!_id){
@@ -88,6 +277,8 @@ void WiFiManagerParameter::setValue(const char *defaultValue, int length) {
   //   // return false; //@todo bail 
   // }
 
+  if(!_ownsValue) length = _length; // fixed buffer, cannot grow
+
   if(_length != length || _value == nullptr){
     _length = length;
     if( _value != nullptr){
@@ -104,7 +295,7 @@ void WiFiManagerParameter::setValue(const char *defaultValue, int length) {
 }
 const char* WiFiManagerParameter::getValue() const {
   // Serial.println(printf("Address of _value is %p\n", (void *)_value)); 
-  return _value;
+  return _value ? _value : ""; // typed parameters have no char value, use getValueString() or get()
 }
 const char* WiFiManagerParameter::getID() const {
   return _id;
@@ -125,6 +316,253 @@ const char* WiFiManagerParameter::getCustomHTML() const {
   return _customHTML;
 }
 
+/**
+ * bind the value to an application owned buffer, the form renders from it and saves write into it
+ * in place, no copy in the save callback, wifimanager allocates nothing for the value
+ * @since $dev
+ * @param char   *buffer
+ * @param size_t  size, bytes including the terminator, values are truncated to size-1
+ */
+void WiFiManagerParameter::bindValue(char *buffer, size_t size) {
+  if(!_id || !buffer || size == 0) return;
+  if(_value != NULL && _ownsValue) delete[] _value;
+  _value     = buffer;
+  _length    = size - 1;
+  _ownsValue = false;
+  _value[_length] = '\0';
+}
+
+/**
+ * set the label, ram or flash, must stay in scope
+ * @since $dev
+ */
+void WiFiManagerParameter::setLabel(const char *label) {
+  _label    = label;
+  _progmem &= ~WM_PARAM_PGM_LABEL;
+}
+
+void WiFiManagerParameter::setLabel(const __FlashStringHelper *label) {
+  _label    = (const char*)label;
+  _progmem |= WM_PARAM_PGM_LABEL;
+}
+
+/**
+ * set the custom html, ram or flash, must stay in scope
+ * @since $dev
+ */
+void WiFiManagerParameter::setCustomHTML(const char *custom) {
+  _customHTML = custom;
+  _progmem   &= ~WM_PARAM_PGM_CUSTOM;
+}
+
+void WiFiManagerParameter::setCustomHTML(const __FlashStringHelper *custom) {
+  _customHTML = (const char*)custom;
+  _progmem   |= WM_PARAM_PGM_CUSTOM;
+}
+
+/**
+ * label as a string, copied from flash if stored there
+ * @since $dev
+ * @return String
+ */
+String WiFiManagerParameter::getLabelString() const {
+  if(!_label) return String();
+  return (_progmem & WM_PARAM_PGM_LABEL) ? String(FPSTR(_label)) : String(_label);
+}
+
+/**
+ * custom html as a string, copied from flash if stored there, overridden getCustomHTML is read from ram
+ * @since $dev
+ * @return String
+ */
+String WiFiManagerParameter::getCustomHTMLString() const {
+  const char *html = getCustomHTML();
+  if(!html) return String();
+  return ((_progmem & WM_PARAM_PGM_CUSTOM) && html == _customHTML) ? String(FPSTR(html)) : String(html);
+}
+
+/**
+ * set a device side validator for submitted values
+ * @since $dev
+ * @param std::function<bool(const String&)> validator, return false to reject
+ */
+void WiFiManagerParameter::setValidator(std::function<bool(const String &value)> validator) {
+  _validator = validator;
+}
+
+bool WiFiManagerParameter::validate(const String &value) const {
+  if(_validator && !_validator(value)) return false;
+  return true;
+}
+
+bool WiFiManagerParameter::setValueFromArg(const String &value) {
+  if(!_value || !validate(value)) return false;
+  value.toCharArray(_value, _length+1); // length+1 null terminated
+  return true;
+}
+
+String WiFiManagerParameter::getValueString() const {
+  return _value ? String(_value) : String();
+}
+
+String WiFiManagerParameter::getInputValue() const {
+  return getValueString();
+}
+
+String WiFiManagerParameter::getInputAttributes() const {
+  return String();
+}
+
+const char* WiFiManagerParameter::getInputTemplate() const {
+  return HTTP_FORM_PARAM;
+}
+
+String WiFiManagerParameter::getInputOptions() const {
+  return String();
+}
+
+size_t WiFiManagerParameter::getStoreSize() const {
+  return (_id && _value) ? _length : 0;
+}
+
+void WiFiManagerParameter::getStoreValue(uint8_t *buf) const {
+  strncpy((char*)buf, _value, _length); // zero padded
+}
+
+bool WiFiManagerParameter::setStoreValue(const uint8_t *buf) {
+  std::unique_ptr<char[]> value(new char[_length + 1]);
+  memcpy(value.get(), buf, _length);
+  value[_length] = '\0';
+  return setValueFromArg(value.get());
+}
+
+/**
+ * put the parameter in a named section, rendered on its own /param?section= sub-page
+ * and saved only when that section is submitted, NULL for the main param page
+ * @since $dev
+ * @param const char *section, must stay in scope
+ */
+void WiFiManagerParameter::setSection(const char *section) {
+  _section = section;
+}
+
+const char* WiFiManagerParameter::getSection() const {
+  return _section;
+}
+
+/**
+ * value changed by the last portal save, compared on native value (typed) or buffer
+ * @since $dev
+ * @return bool
+ */
+bool WiFiManagerParameter::isDirty() const {
+  return _dirty;
+}
+
+/**
+ * set a callback fired when a portal save changes this parameter's value
+ * @since $dev
+ * @param std::function<void(WiFiManagerParameter*)> func
+ */
+void WiFiManagerParameter::setChangedCallback(std::function<void(WiFiManagerParameter *param)> func) {
+  _changedcallback = func;
+}
+
+/**
+ * --------------------------------------------------------------------------------
+ *  Typed parameters
+ * --------------------------------------------------------------------------------
+**/
+
+bool WiFiManagerParameterTraits<int>::parse(const String &str, int &value) {
+  char *end;
+  errno = 0;
+  long v = strtol(str.c_str(), &end, 10);
+  if(str == "" || *end != '\0') return false;
+  if(errno == ERANGE || v < INT_MIN || v > INT_MAX) return false; // overflow, would wrap before the range check
+  value = (int)v;
+  return true;
+}
+
+String WiFiManagerParameterTraits<int>::attributes(const int &value, const int &min, const int &max, bool ranged) {
+  (void)value;
+  String attr = F("type='number' step='1'");
+  if(ranged) attr += (String)F(" min='") + min + F("' max='") + max + "'";
+  return attr;
+}
+
+bool WiFiManagerParameterTraits<float>::parse(const String &str, float &value) {
+  char *end;
+  double v = strtod(str.c_str(), &end);
+  if(str == "" || *end != '\0') return false;
+  value = (float)v;
+  return true;
+}
+
+String WiFiManagerParameterTraits<float>::toString(const float &value) {
+  String str(value, 6);
+  // trim trailing zeros, keep one decimal
+  int len = str.length();
+  while(len > 2 && str[len-1] == '0' && str[len-2] != '.') len--;
+  str.remove(len);
+  return str;
+}
+
+String WiFiManagerParameterTraits<float>::attributes(const float &value, const float &min, const float &max, bool ranged) {
+  (void)value;
+  String attr = F("type='number' step='any'");
+  if(ranged) attr += (String)F(" min='") + toString(min) + F("' max='") + toString(max) + "'";
+  return attr;
+}
+
+bool WiFiManagerParameterTraits<bool>::parse(const String &str, bool &value) {
+  // unchecked checkboxes are not submitted
+  value = str == "1" || str == "on" || str == "true";
+  return true;
+}
+
+String WiFiManagerParameterTraits<bool>::attributes(const bool &value, const bool &min, const bool &max, bool ranged) {
+  (void)min; (void)max; (void)ranged;
+  String attr = F("type='checkbox'");
+  if(value) attr += F(" checked");
+  return attr;
+}
+
+String WiFiManagerParameterTraits<IPAddress>::attributes(const IPAddress &value, const IPAddress &min, const IPAddress &max, bool ranged) {
+  (void)value; (void)min; (void)max; (void)ranged;
+  return F("inputmode='decimal'");
+}
+
+WiFiManagerParameterSelect::WiFiManagerParameterSelect(const char *id, const char *label, const char * const *options, uint8_t count, int defaultValue, const char *custom, int labelPlacement)
+  : WiFiManagerParameterT<int>(id, label, defaultValue, 0, count > 0 ? count-1 : 0, custom, labelPlacement) {
+  _options = options;
+  _count   = count;
+}
+
+const char* WiFiManagerParameterSelect::getOption() const {
+  return (_options && *_ref >= 0 && *_ref < _count) ? _options[*_ref] : "";
+}
+
+String WiFiManagerParameterSelect::getInputAttributes() const {
+  return String();
+}
+
+const char* WiFiManagerParameterSelect::getInputTemplate() const {
+  return HTTP_FORM_SELECT;
+}
+
+String WiFiManagerParameterSelect::getInputOptions() const {
+  String options;
+  for(uint8_t i = 0; i < _count; i++){
+    String item = FPSTR(HTTP_FORM_OPTION);
+    item.replace(FPSTR(T_v), (String)i);
+    item.replace(FPSTR(T_c), i == *_ref ? F(" selected") : F(""));
+    item.replace(FPSTR(T_t), WiFiManager::htmlEntities(_options[i]));
+    options += item;
+  }
+  return options;
+}
+
 /**
  * [addParameter description]
  * @access public
@@ -145,43 +583,223 @@ bool WiFiManager::addParameter(WiFiManagerParameter *p) {
   }
 
   // init params if never malloc
-  if(_params == NULL){
+  if(_params == NULL && !paramsResize(_max_params)) return false;
+
+  // resize the params array by increment of WIFI_MANAGER_MAX_PARAMS
+  if(_paramsCount == _max_params && !paramsResize(_max_params + WIFI_MANAGER_MAX_PARAMS)) return false;
+
+  _params[_paramsCount] = p;
+  _paramsCount++;
+  paramIndexAdd(_paramsCount - 1);
+  
+  #ifdef WM_DEBUG_LEVEL
+  DEBUG_WM(WM_DEBUG_VERBOSE,F("Added Parameter:"),p->getID());
+  #endif
+  return true;
+}
+
+/**
+ * allocate or grow the params pointer array
+ * @since $dev
+ * @param  int  max slots
+ * @return bool success
+ */
+bool WiFiManager::paramsResize(int max){
+  #ifdef WM_DEBUG_LEVEL
+  DEBUG_WM(WM_DEBUG_DEV,F("allocating params bytes:"),max * sizeof(WiFiManagerParameter*));
+  #endif
+  WiFiManagerParameter** new_params = (WiFiManagerParameter**)realloc(_params, max * sizeof(WiFiManagerParameter*));
+  if (new_params == NULL) {
     #ifdef WM_DEBUG_LEVEL
-    DEBUG_WM(WM_DEBUG_DEV,F("allocating params bytes:"),_max_params * sizeof(WiFiManagerParameter*));        
+    DEBUG_WM(WM_DEBUG_ERROR,F("[ERROR] failed to realloc params, size not increased!"));
     #endif
-    _params = (WiFiManagerParameter**)malloc(_max_params * sizeof(WiFiManagerParameter*));
+    return false;
   }
+  _params     = new_params;
+  _max_params = max;
+  return true;
+}
 
-  // resize the params array by increment of WIFI_MANAGER_MAX_PARAMS
-  if(_paramsCount == _max_params){
-    _max_params += WIFI_MANAGER_MAX_PARAMS;
+/**
+ * reserve parameter storage up front
+ * count slots in the params array, and a single arena of bytes for parameters added by value
+ * (wm.addParameter(WiFiManagerParameterT<int>(..))) and their value buffers, no per parameter allocations
+ * the arena can only be reserved once, parameters added by value after it fills go on the heap
+ * @since $dev
+ * @access public
+ * @param  uint8_t count parameters
+ * @param  size_t  bytes arena size, 0 for none
+ * @return bool    success
+ */
+bool WiFiManager::reserveParameters(uint8_t count, size_t bytes){
+  if(count > _max_params || _params == NULL){
+    if(!paramsResize(std::max((int)count,_max_params))) return false;
+  }
+  if(bytes == 0) return true;
+  if(_paramArena){
     #ifdef WM_DEBUG_LEVEL
-    DEBUG_WM(WM_DEBUG_DEV,F("Updated _max_params:"),_max_params);
-    DEBUG_WM(WM_DEBUG_DEV,F("re-allocating params bytes:"),_max_params * sizeof(WiFiManagerParameter*));    
+    DEBUG_WM(WM_DEBUG_ERROR,F("[ERROR] parameter arena already reserved"));
     #endif
-    WiFiManagerParameter** new_params = (WiFiManagerParameter**)realloc(_params, _max_params * sizeof(WiFiManagerParameter*));
+    return false;
+  }
+  _paramArena.reset(new (std::nothrow) uint8_t[bytes]);
+  _paramArenaSize = _paramArena ? bytes : 0;
+  _paramArenaUsed = 0;
+  #ifdef WM_DEBUG_LEVEL
+  DEBUG_WM(WM_DEBUG_DEV,F("parameter arena bytes:"),_paramArenaSize);
+  #endif
+  return _paramArenaSize > 0;
+}
+
+/**
+ * allocate from the parameter arena
+ * @since $dev
+ * @param  size_t size
+ * @param  size_t align
+ * @return void*  NULL if not reserved or full
+ */
+void* WiFiManager::paramAlloc(size_t size, size_t align){
+  if(!_paramArena) return NULL;
+  size_t offset = (_paramArenaUsed + align - 1) & ~(align - 1);
+  if(offset + size > _paramArenaSize){
     #ifdef WM_DEBUG_LEVEL
-    // DEBUG_WM(WIFI_MANAGER_MAX_PARAMS);
-    // DEBUG_WM(_paramsCount);
-    // DEBUG_WM(_max_params);
+    DEBUG_WM(WM_DEBUG_VERBOSE,F("parameter arena full, bytes needed:"),offset + size - _paramArenaSize);
     #endif
-    if (new_params != NULL) {
-      _params = new_params;
-    } else {
+    return NULL;
+  }
+  _paramArenaUsed = offset + size;
+  return _paramArena.get() + offset;
+}
+
+/**
+ * move an owned parameter's heap value buffer into the arena
+ * @since $dev
+ * @param WiFiManagerParameter *p
+ */
+void WiFiManager::paramAdopt(WiFiManagerParameter *p){
+  if(!p->_ownsValue || p->_value == NULL) return;
+  char *buf = (char*)paramAlloc(p->_length + 1, 1);
+  if(!buf) return;
+  memcpy(buf, p->_value, p->_length + 1);
+  delete[] p->_value;
+  p->_value     = buf;
+  p->_ownsValue = false;
+}
+
+/**
+ * destroy a parameter owned by wifimanager, arena space is not reused
+ * @since $dev
+ * @param WiFiManagerParameter *p
+ */
+void WiFiManager::paramFree(WiFiManagerParameter *p){
+  if(p->_storage == WM_PARAM_ARENA) p->~WiFiManagerParameter();
+  else if(p->_storage == WM_PARAM_HEAP) delete p;
+}
+
+/**
+ * parameter store
+ * each parameter value is kept as its own binary record in the flash store (LittleFS on esp8266, NVS on esp32),
+ * crc checked, keyed by a hash of the parameter id. typed parameters store native values, others their char buffer.
+ * records are loaded before autoConnect and the portal, and only changed records are written on save.
+ * a record whose size or version does not match is ignored, the parameter keeps its default.
+ * requires the WM_FLASHSTORE build flag
+ * @since $dev
+ * @access public
+ * @param bool     enable
+ * @param uint16_t version, bump when parameter meaning changes to drop old records
+ */
+void WiFiManager::setParamStore(bool enable, uint16_t version){
+  _paramStore    = enable;
+  _paramStoreVer = version;
+  #if !defined(WM_FLASHSTORE) && defined(WM_DEBUG_LEVEL)
+  if(enable) DEBUG_WM(WM_DEBUG_ERROR,F("[ERROR] parameter store requires WM_FLASHSTORE"));
+  #endif
+}
+
+/**
+ * parameter store record key, "p" and the fnv-1a hash of the id in hex
+ * @since $dev
+ * @param WiFiManagerParameter *p
+ * @param char                 *key out, 10 bytes
+ */
+void WiFiManager::paramStoreKey(const WiFiManagerParameter *p, char *key){
+  snprintf(key, 10, "p%08x", (unsigned int)wm_fnv1a(p->getID()));
+}
+
+/**
+ * crc of a parameter's value record, change detection for saves and the store
+ * @since $dev
+ * @param  WiFiManagerParameter *p
+ * @return uint32_t crc, 0 if the parameter has no value
+ */
+uint32_t WiFiManager::paramCrc(const WiFiManagerParameter *p){
+  size_t len = p->getStoreSize();
+  if(len == 0) return 0;
+  std::unique_ptr<uint8_t[]> buf(new uint8_t[len]());
+  p->getStoreValue(buf.get());
+  return wm_crc32(buf.get(), len);
+}
+
+/**
+ * load stored parameter values, parameters added since the last load only
+ * @since $dev
+ * @access public
+ * @return int records loaded
+ */
+int WiFiManager::loadParameters(){
+  int loaded = 0;
+  char key[10];
+  for (; _paramsLoaded < _paramsCount; _paramsLoaded++) {
+    WiFiManagerParameter *p = _params[_paramsLoaded];
+    size_t len = p->getStoreSize();
+    if(!p->getID() || len == 0) continue;
+    std::unique_ptr<uint8_t[]> buf(new uint8_t[len]);
+    paramStoreKey(p, key);
+    if(!storeRead(key, buf.get(), len, _paramStoreVer)) continue;
+    if(!p->setStoreValue(buf.get())){
       #ifdef WM_DEBUG_LEVEL
-      DEBUG_WM(WM_DEBUG_ERROR,F("[ERROR] failed to realloc params, size not increased!"));
+      DEBUG_WM(WM_DEBUG_ERROR,F("[ERROR] stored parameter value rejected:"),p->getID());
       #endif
-      return false;
+      continue;
     }
+    p->_storeCrc = wm_crc32(buf.get(), len);
+    loaded++;
   }
+  #ifdef WM_DEBUG_LEVEL
+  if(loaded) DEBUG_WM(WM_DEBUG_VERBOSE,F("parameters loaded:"),loaded);
+  #endif
+  return loaded;
+}
 
-  _params[_paramsCount] = p;
-  _paramsCount++;
-  
+/**
+ * write parameter values changed since they were loaded or stored
+ * @since $dev
+ * @access public
+ * @return int records written, -1 on failures
+ */
+int WiFiManager::saveParameters(){
+  int written = 0;
+  bool ok     = true;
+  char key[10];
+  for (int i = 0; i < _paramsCount; i++) {
+    WiFiManagerParameter *p = _params[i];
+    size_t len = p->getStoreSize();
+    if(!p->getID() || len == 0) continue;
+    std::unique_ptr<uint8_t[]> buf(new uint8_t[len]());
+    p->getStoreValue(buf.get());
+    uint32_t crc = wm_crc32(buf.get(), len);
+    if(crc == p->_storeCrc) continue; // unchanged since loaded or stored
+    paramStoreKey(p, key);
+    if(storeWrite(key, buf.get(), len, _paramStoreVer)){
+      p->_storeCrc = crc;
+      written++;
+    }
+    else ok = false;
+  }
   #ifdef WM_DEBUG_LEVEL
-  DEBUG_WM(WM_DEBUG_VERBOSE,F("Added Parameter:"),p->getID());
+  DEBUG_WM(WM_DEBUG_VERBOSE,F("parameters stored:"),written);
   #endif
-  return true;
+  return ok ? written : -1;
 }
 
 /**
@@ -200,6 +818,83 @@ int WiFiManager::getParametersCount() {
   return _paramsCount;
 }
 
+/**
+ * parameter by id, O(1) through the id hash index
+ * @since $dev
+ * @access public
+ * @param  const char *id
+ * @return WiFiManagerParameter* or NULL, the first added if ids repeat
+ */
+WiFiManagerParameter* WiFiManager::getParameter(const char *id) {
+  int i = paramIndexFind(id);
+  return i < 0 ? NULL : _params[i];
+}
+
+/**
+ * iterable list of the added parameters, in add order
+ * @since $dev
+ * @access public
+ * @return WiFiManagerParameterList
+ */
+WiFiManagerParameterList WiFiManager::parameters() {
+  return {_params, _paramsCount};
+}
+
+/**
+ * find a parameter index by id in the hash index, linear probing
+ * falls back to a scan if the index could not be allocated
+ * @since $dev
+ * @param  const char *id
+ * @return int index in _params, -1 not found
+ */
+int WiFiManager::paramIndexFind(const char *id){
+  if(!id) return -1;
+  if(!_paramIndex){
+    for (int i = 0; i < _paramsCount; i++) {
+      if(_params[i]->getID() && strcmp(_params[i]->getID(), id) == 0) return i;
+    }
+    return -1;
+  }
+  uint16_t mask = _paramIndexSize - 1;
+  for (uint16_t slot = wm_fnv1a(id) & mask; _paramIndex[slot]; slot = (slot + 1) & mask) {
+    int i = _paramIndex[slot] - 1;
+    if(strcmp(_params[i]->getID(), id) == 0) return i;
+  }
+  return -1;
+}
+
+/**
+ * add a parameter to the id hash index, grown to keep the load under half
+ * @since $dev
+ * @param int i index in _params
+ */
+void WiFiManager::paramIndexAdd(int i){
+  if(!_params[i]->getID()) return; // custom html only
+  if(_paramsCount * 2 > _paramIndexSize){
+    uint16_t size = _paramIndexSize ? _paramIndexSize : 8;
+    while(_paramsCount * 2 > size) size <<= 1;
+    _paramIndex.reset(new (std::nothrow) uint16_t[size]());
+    _paramIndexSize = _paramIndex ? size : 0;
+    if(!_paramIndex) return;
+    for (int j = 0; j < i; j++) paramIndexAdd(j); // rehash
+  }
+  if(!_paramIndex || paramIndexFind(_params[i]->getID()) >= 0) return; // first added wins
+  uint16_t mask = _paramIndexSize - 1;
+  uint16_t slot = wm_fnv1a(_params[i]->getID()) & mask;
+  while(_paramIndex[slot]) slot = (slot + 1) & mask;
+  _paramIndex[slot] = i + 1;
+}
+
+/**
+ * number of parameters whose value changed in the last portal save
+ * @since $dev
+ * @access public
+ * @return int
+ */
+int WiFiManager::getParamsChanged() {
+  return _paramsChanged;
+}
+
 /**
  * --------------------------------------------------------------------------------
  *  WiFiManager 
@@ -230,6 +925,8 @@ WiFiManager::~WiFiManager() {
     #ifdef WM_DEBUG_LEVEL
     DEBUG_WM(WM_DEBUG_DEV,F("freeing allocated params!"));
     #endif
+    for (WiFiManagerParameter *p : _paramsOwned) paramFree(p); // owned parameters, before the arena goes
+    _paramsOwned.clear();
     free(_params);
     _params = NULL;
   }
@@ -238,6 +935,7 @@ WiFiManager::~WiFiManager() {
   // WiFi.onEvent(std::bind(&WiFiManager::WiFiEvent,this,_1,_2));
   #ifdef ESP32
     WiFi.removeEvent(wm_event_id);
+    if(_conxEvent) vSemaphoreDelete(_conxEvent);
   #endif
 
   #ifdef WM_DEBUG_LEVEL
@@ -280,21 +978,28 @@ boolean WiFiManager::autoConnect(char const *apName, char const *apPassword) {
   DEBUG_WM(F("AutoConnect"));
   #endif
 
+  if(_paramStore) loadParameters();
+
   // bool wifiIsSaved = getWiFiIsSaved();
   bool wifiIsSaved = true; // workaround until I can check esp32 wifiisinit and has nvs
 
+  // fast boot, config unchanged since the last successful boot, skip setup already applied
+  uint32_t bootcfg = _fastBoot ? fastBootFingerprint() : 0;
+  bool fastBoot = _fastBoot && rtcLoad() && _rtc.bootcfg == bootcfg;
+  #ifdef WM_DEBUG_LEVEL
+  if(fastBoot) DEBUG_WM(WM_DEBUG_VERBOSE,F("Fast boot, config unchanged"));
+  #endif
+
   #ifdef ESP32
-  setupHostname(true);
+  bool hostApplied = fastBoot && getWiFiHostname() == _hostname;
+  if(!hostApplied) setupHostname(true);
 
-  if(_hostname != ""){
+  if(_hostname != "" && !hostApplied){
     // disable wifi if already on
     if(WiFi.getMode() & WIFI_STA){
       WiFi.mode(WIFI_OFF);
-      int timeout = millis()+1200;
       // async loop for mode change
-      while(WiFi.getMode()!= WIFI_OFF && millis()<timeout){
-        delay(0);
-      }
+      waitFor([](){ return WiFi.getMode() == WIFI_OFF; },1200,WM_WAIT_WIFIOFF);
     }
   }
   #endif
@@ -306,7 +1011,7 @@ boolean WiFiManager::autoConnect(char const *apName, char const *apPassword) {
     _begin();
 
     // attempt to connect using saved settings, on fail fallback to AP config portal
-    if(!WiFi.enableSTA(true)){
+    if(!(fastBoot && (WiFi.getMode() & WIFI_STA)) && !WiFi.enableSTA(true)){
       // handle failure mode Brownout detector etc.
       #ifdef WM_DEBUG_LEVEL
       DEBUG_WM(WM_DEBUG_ERROR,F("[FATAL] Unable to enable wifi!"));
@@ -314,7 +1019,7 @@ boolean WiFiManager::autoConnect(char const *apName, char const *apPassword) {
       return false;
     }
     
-    WiFiSetCountry();
+    if(!fastBoot || !WiFi_countryApplied()) WiFiSetCountry();
 
     #ifdef ESP32
     if(esp32persistent) WiFi.persistent(false); // disable persistent for esp32 after esp_wifi_start or else saves wont work
@@ -328,7 +1033,11 @@ boolean WiFiManager::autoConnect(char const *apName, char const *apPassword) {
     WiFi_autoReconnect();
 
     #ifdef ESP8266
-    if(_hostname != ""){
+    bool hostApplied = fastBoot && getWiFiHostname() == _hostname;
+    #ifdef WM_MDNS
+    hostApplied = false; // mdns is not running after a boot, always setup
+    #endif
+    if(_hostname != "" && !hostApplied){
       setupHostname(true);
     }
     #endif
@@ -347,7 +1056,15 @@ boolean WiFiManager::autoConnect(char const *apName, char const *apPassword) {
       // and we have no idea WHAT we are connected to
     }
 
-    if(connected || connectWifi(_defaultssid, _defaultpass) == WL_CONNECTED){
+    // credential store, pick the best stored network from one scan instead of the single saved one
+    if(_credStore) credMigrate();
+    bool useCreds = !connected && _credStore && _defaultssid == "" && credLoad() && _creds->count;
+
+    // scan gate, do not wait out connect timeouts for a network that is not in range
+    bool inRange = connected || useCreds || !_scanGate || connectScanGate(_defaultssid != "" ? _defaultssid : WiFi_SSID(true));
+    if(!inRange) _lastconxresult = WL_NO_SSID_AVAIL;
+
+    if(connected || (inRange && (useCreds ? connectCredentials() : connectWifi(_defaultssid, _defaultpass)) == WL_CONNECTED)){
       //connected
       #ifdef WM_DEBUG_LEVEL
       DEBUG_WM(F("AutoConnect: SUCCESS"));
@@ -357,6 +1074,13 @@ boolean WiFiManager::autoConnect(char const *apName, char const *apPassword) {
       // Serial.println("Connected in " + (String)((millis()-_startconn)) + " ms");
       _lastconxresult = WL_CONNECTED;
 
+      // remember the applied config for the next fast boot
+      if(_fastBoot && !fastBoot){
+        rtcLoad();
+        _rtc.bootcfg = bootcfg;
+        rtcSave();
+      }
+
       if(_hostname != ""){
         #ifdef WM_DEBUG_LEVEL
           DEBUG_WM(WM_DEBUG_DEV,F("hostname: STA: "),getWiFiHostname());
@@ -454,7 +1178,7 @@ bool WiFiManager::setupHostname(bool restart){
     #endif
     // WiFi.reconnect(); // This does not reset dhcp
     WiFi_Disconnect();
-    delay(200); // do not remove, need a delay for disconnect to change status()
+    waitFor([](){ return WiFi.status() != WL_CONNECTED; },200,WM_WAIT_HOSTNAME); // do not remove, need to wait for disconnect to change status()
   }
 
   return res;
@@ -528,10 +1252,9 @@ bool WiFiManager::startAP(){
 
   // @todo add softAP retry here to dela with unknown failures
   
-  delay(500); // slight delay to make sure we get an AP IP
+  // ap ip readiness is waited on in startConfigPortal, see apReady()
   #ifdef WM_DEBUG_LEVEL
   if(!ret) DEBUG_WM(WM_DEBUG_ERROR,F("[ERROR] There was a problem starting the AP"));
-  DEBUG_WM(F("AP IP address:"),WiFi.softAPIP());
   #endif
 
   // set ap hostname
@@ -557,6 +1280,8 @@ bool WiFiManager::startAP(){
 void WiFiManager::startWebPortal() {
   if(configPortalActive || webPortalActive) return;
   connect = abort = false;
+  _portalStartMs = millis();
+  _portalReadyMs = 0;
   setupConfigPortal();
   webPortalActive = true;
 }
@@ -644,6 +1369,7 @@ void WiFiManager::setupHTTPServer(){
   server->on(WM_G(R_root),       std::bind(&WiFiManager::handleRoot, this));
   server->on(WM_G(R_wifi),       std::bind(&WiFiManager::handleWifi, this, true));
   server->on(WM_G(R_wifinoscan), std::bind(&WiFiManager::handleWifi, this, false));
+  server->on(WM_G(R_wifiscan),   std::bind(&WiFiManager::handleWifiScan, this));
   server->on(WM_G(R_wifisave),   std::bind(&WiFiManager::handleWifiSave, this));
   server->on(WM_G(R_info),       std::bind(&WiFiManager::handleInfo, this));
   server->on(WM_G(R_param),      std::bind(&WiFiManager::handleParam, this));
@@ -653,6 +1379,8 @@ void WiFiManager::setupHTTPServer(){
   server->on(WM_G(R_close),      std::bind(&WiFiManager::handleClose, this));
   server->on(WM_G(R_erase),      std::bind(&WiFiManager::handleErase, this, false));
   server->on(WM_G(R_status),     std::bind(&WiFiManager::handleWiFiStatus, this));
+  server->on(WM_G(R_conxlog),    std::bind(&WiFiManager::handleConxLog, this));
+  if(_configApi) server->on(WM_G(R_apiconfig), std::bind(&WiFiManager::handleConfigApi, this));
   server->onNotFound (std::bind(&WiFiManager::handleNotFound, this));
   
   server->on(WM_G(R_update), std::bind(&WiFiManager::handleUpdate, this));
@@ -676,7 +1404,8 @@ void WiFiManager::setupDNSD(){
   dnsServer->start(DNS_PORT, F("*"), WiFi.softAPIP());
 }
 
-void WiFiManager::setupConfigPortal() {
+void WiFiManager::setupConfigPortal(bool loadParams) {
+  if(loadParams && _paramStore) loadParameters(); // stored values before the first render
   setupHTTPServer();
   _lastscan = 0; // reset network scan cache
   if(_preloadwifiscan) WiFi_scanNetworks(true,true); // preload wifiscan , async
@@ -695,6 +1424,7 @@ boolean WiFiManager::startConfigPortal() {
  * @return {[type]}      [description]
  */
 boolean  WiFiManager::startConfigPortal(char const *apName, char const *apPassword) {
+  unsigned long portalStart = millis();
   _begin();
 
   if(configPortalActive){
@@ -738,6 +1468,8 @@ boolean  WiFiManager::startConfigPortal(char const *apName, char const *apPasswo
   uint8_t state;
 
   _configPortalStart = millis();
+  _portalStartMs     = portalStart;
+  _portalReadyMs     = 0;
 
   // start access point
   #ifdef WM_DEBUG_LEVEL
@@ -746,6 +1478,15 @@ boolean  WiFiManager::startConfigPortal(char const *apName, char const *apPasswo
   startAP();
   WiFiSetCountry();
 
+  // stored params do not need the ap, load them while the softap comes up
+  if(_paramStore) loadParameters();
+
+  // the ap callback and dns need the ap up with an ip
+  waitFor([this](){ return apReady(); },1000,WM_WAIT_APIP);
+  #ifdef WM_DEBUG_LEVEL
+  DEBUG_WM(F("AP IP address:"),WiFi.softAPIP());
+  #endif
+
   // do AP callback if set
   if ( _apcallback != NULL) {
     #ifdef WM_DEBUG_LEVEL
@@ -758,7 +1499,7 @@ boolean  WiFiManager::startConfigPortal(char const *apName, char const *apPasswo
   #ifdef WM_DEBUG_LEVEL
   DEBUG_WM(WM_DEBUG_DEV,F("setupConfigPortal"));
   #endif
-  setupConfigPortal();
+  setupConfigPortal(false); // params already loaded
 
   #ifdef WM_DEBUG_LEVEL
   DEBUG_WM(WM_DEBUG_DEV,F("setupDNSD"));
@@ -812,13 +1553,335 @@ boolean  WiFiManager::startConfigPortal(char const *apName, char const *apPasswo
 
     if(!configPortalActive) break;
 
-    yield(); // watchdog
-  }
+    yield(); // watchdog
+  }
+
+  #ifdef WM_DEBUG_LEVEL
+  DEBUG_WM(WM_DEBUG_NOTIFY,F("config portal exiting"));
+  #endif
+  return result;
+}
+
+/**
+ * autoConnectAsync
+ * non blocking autoConnect, starts the connect and returns, process() advances
+ * connecting, retrying, portal fallback and connected, connect attempts do not block.
+ * the portal fallback is always non blocking, state changes are reported to setAsyncConnectCallback
+ * starting the fallback portal still runs the bounded ap start waits in startConfigPortal
+ * the users setConfigPortalBlocking setting is restored when the fallback portal closes
+ * with nothing saved the fallback portal starts at once
+ * connects the default or saved ssid only, the credential store and scan gate
+ * need blocking scans and are not used, call autoConnect for those
+ * @since $dev
+ * @access public
+ * @param  char const *apName     portal fallback ap name
+ * @param  char const *apPassword portal fallback ap password
+ * @return bool started
+ */
+boolean WiFiManager::autoConnectAsync() {
+  String ssid = getDefaultAPName();
+  return autoConnectAsync(ssid.c_str(), NULL);
+}
+
+boolean WiFiManager::autoConnectAsync(char const *apName, char const *apPassword) {
+  #ifdef WM_DEBUG_LEVEL
+  DEBUG_WM(F("AutoConnect async"));
+  #endif
+  _asyncApName     = apName;
+  _asyncApPassword = apPassword ? apPassword : "";
+  _asyncState      = WM_ASYNC_IDLE;
+  _startconn       = millis();
+  _begin();
+
+  #ifdef ESP32
+  setupHostname(false); // must be set before sta start, no wifi off toggle here as it waits
+  #endif
+
+  if(!WiFi.enableSTA(true)){
+    #ifdef WM_DEBUG_LEVEL
+    DEBUG_WM(WM_DEBUG_ERROR,F("[FATAL] Unable to enable wifi!"));
+    #endif
+    asyncConnectState(WM_ASYNC_FAILED);
+    return false;
+  }
+
+  WiFiSetCountry();
+
+  #ifdef ESP32
+  if(esp32persistent) WiFi.persistent(false); // disable persistent for esp32 after esp_wifi_start or else saves wont work
+  #endif
+
+  _usermode = WIFI_STA;
+  WiFi_autoReconnect();
+
+  #ifdef ESP8266
+  if(_hostname != "") setupHostname(false);
+  #endif
+
+  if(WiFi.status() == WL_CONNECTED){
+    #ifdef WM_DEBUG_LEVEL
+    DEBUG_WM(F("AutoConnect: ESP Already Connected"));
+    #endif
+    setSTAConfig();
+    _lastconxresult = WL_CONNECTED;
+    asyncConnectState(WM_ASYNC_CONNECTED);
+    return true;
+  }
+
+  if(_defaultssid == "" && !WiFi_hasAutoConnect()){
+    #ifdef WM_DEBUG_LEVEL
+    DEBUG_WM(F("No Credentials are Saved, skipping connect"));
+    #endif
+    asyncConnectFallback();
+    return true;
+  }
+
+  _asyncRetry = _fastConnect ? 0 : 1;
+  asyncConnectBegin();
+  return true;
+}
+
+/**
+ * start an autoConnectAsync attempt, begin only, no waits
+ * @since $dev
+ */
+void WiFiManager::asyncConnectBegin(){
+  _connecting = true;
+  WiFi_registerEvents();
+  setSTAConfig();
+  if(_dhcpCache && !_sta_static_ip) _ipcStats.cached = dhcpCacheApply(_defaultssid != "" ? _defaultssid : WiFi_SSID(true));
+
+  if(_asyncRetry == 0 && !wifiConnectFast(_defaultssid,_defaultpass)) _asyncRetry = 1; // no fast connect cache
+  if(_asyncRetry > 0){
+    #ifdef WM_DEBUG_LEVEL
+    DEBUG_WM(F("Connect Wifi async, ATTEMPT #"),(String)_asyncRetry+" of "+(String)_connectRetries);
+    #endif
+    conxTimelineStart(_asyncRetry);
+    if(_defaultssid != "") wifiConnectNew(_defaultssid,_defaultpass);
+    else if(_fastConnect) wifiConnectNew(WiFi_SSID(true),WiFi_psk(true)); // explicit credentials clear a fast connect bssid lock
+    else if(WiFi_hasAutoConnect()){
+      // wifiConnectDefault without the mode settle delay
+      WiFi_enableSTA(true,storeSTAmode);
+      if(_conxCur) _conxCur->mode = millis();
+      WiFi.begin();
+      if(_conxCur) _conxCur->begin = millis();
+    }
+  }
+  _asyncTimer = millis();
+  asyncConnectState(WM_ASYNC_CONNECTING);
+}
+
+/**
+ * advance autoConnectAsync, called from process()
+ * @since $dev
+ */
+void WiFiManager::asyncConnectProcess(){
+  if(_asyncState == WM_ASYNC_RETRYING){
+    if(millis() - _asyncTimer < (_aggresiveReconn ? 1000UL : 0UL)) return; // idle time before recon
+    asyncConnectBegin();
+    return;
+  }
+
+  uint8_t status = WiFi_connectStatus();
+  unsigned long timeout = _asyncRetry == 0 ? _fastConnectTimeout : (_defaultssid != "" && _saveTimeout > 0 ? _saveTimeout : _connectTimeout);
+  if(timeout == 0) timeout = 60000;
+  if(status != WL_CONNECTED && status != WL_CONNECT_FAILED && status != WL_NO_SSID_AVAIL && millis() - _asyncTimer < timeout) return; // still connecting
+
+  conxTimelineEnd(status);
+  _connecting = false;
+
+  if(status == WL_CONNECTED){
+    updateConxResult(status);
+    if(_fastConnect) fastConnectSave();
+    if(_dhcpCache && !_sta_static_ip) dhcpCacheUpdate(millis() - _startconn);
+    #ifdef WM_DEBUG_LEVEL
+    DEBUG_WM(F("AutoConnect: SUCCESS"));
+    DEBUG_WM(WM_DEBUG_VERBOSE,F("Connected in"),(String)((millis()-_startconn)) + " ms");
+    DEBUG_WM(F("STA IP Address:"),WiFi.localIP());
+    #endif
+    asyncConnectState(WM_ASYNC_CONNECTED);
+    return;
+  }
+
+  if(_asyncRetry == 0){
+    #ifdef WM_DEBUG_LEVEL
+    DEBUG_WM(F("Fast connect failed, falling back to normal connect"));
+    #endif
+    fastConnectClear();
+    WiFi_Disconnect();
+    _asyncRetry = 1;
+    asyncConnectBegin();
+    return;
+  }
+
+  updateConxResult(status);
+  if(++_asyncRetry <= _connectRetries){
+    _asyncTimer = millis();
+    asyncConnectState(WM_ASYNC_RETRYING);
+    return;
+  }
+
+  #ifdef WM_DEBUG_LEVEL
+  DEBUG_WM(F("AutoConnect: FAILED for "),(String)((millis()-_startconn)) + " ms");
+  #endif
+  asyncConnectFallback();
+}
+
+/**
+ * autoConnectAsync gave up, start the fallback portal or fail
+ * @since $dev
+ */
+void WiFiManager::asyncConnectFallback(){
+  if(!_enableConfigPortal){
+    #ifdef WM_DEBUG_LEVEL
+    DEBUG_WM(WM_DEBUG_VERBOSE,F("enableConfigPortal: FALSE, skipping "));
+    #endif
+    asyncConnectState(WM_ASYNC_FAILED);
+    return;
+  }
+  startConfigPortalNonBlocking(_asyncApName,_asyncApPassword);
+  asyncConnectState(WM_ASYNC_PORTAL);
+}
+
+/**
+ * start a non blocking config portal from an internal flow
+ * the users blocking setting is restored when the portal closes
+ * @since $dev
+ * @param  String apName
+ * @param  String apPassword, empty for open
+ * @return boolean startConfigPortal result
+ */
+boolean WiFiManager::startConfigPortalNonBlocking(const String &apName, const String &apPassword){
+  if(!_configPortalBlockingRestore) _configPortalBlockingUser = _configPortalIsBlocking;
+  _configPortalBlockingRestore = true;
+  _configPortalIsBlocking      = false;
+  boolean ret = startConfigPortal(apName.c_str(),apPassword != "" ? apPassword.c_str() : NULL);
+  if(!configPortalActive){
+    _configPortalIsBlocking      = _configPortalBlockingUser; // portal did not start
+    _configPortalBlockingRestore = false;
+  }
+  return ret;
+}
+
+/**
+ * managed reconnect, called from process()
+ * tracks outages, reconnects on a jittered exponential backoff and
+ * starts a non blocking config portal when the outage budget runs out
+ * an attempt runs until it fails or times out, the backoff counts from its end
+ * @since $dev
+ */
+void WiFiManager::reconnectProcess(){
+  unsigned long now = millis();
+
+  if(WiFi.status() == WL_CONNECTED){
+    _reconnAttempt = 0;
+    if(_reconnDown){
+      _reconnStats.offlineMs += now - _reconnDown;
+      _reconnStats.outageMs   = 0;
+      _reconnStats.nextMs     = 0;
+      #ifdef WM_DEBUG_LEVEL
+      DEBUG_WM(F("Reconnected after"),(String)(now - _reconnDown) + " ms");
+      #endif
+      _reconnDown = 0;
+    }
+    return;
+  }
+
+  // no saved network to reconnect to
+  if(_defaultssid == "" && !WiFi_hasAutoConnect()) return;
+
+  // outage start, first attempt after a jittered base interval
+  if(!_reconnDown){
+    _reconnDown     = _reconnLast = now;
+    _reconnInterval = _reconnBase;
+    _reconnStats.nextMs = reconnectJitter(_reconnInterval);
+    _reconnStats.outages++;
+    #ifdef WM_DEBUG_LEVEL
+    DEBUG_WM(F("Connection lost, reconnect in"),(String)_reconnStats.nextMs + " ms");
+    #endif
+    return;
+  }
+
+  if(_reconnOutage > 0 && now - _reconnDown >= _reconnOutage && _enableConfigPortal){
+    #ifdef WM_DEBUG_LEVEL
+    DEBUG_WM(F("Outage budget exceeded, starting config portal"));
+    #endif
+    _reconnStats.portals++;
+    _reconnStats.offlineMs += now - _reconnDown;
+    _reconnDown    = 0; // fresh outage budget if still offline when the portal closes
+    _reconnAttempt = 0;
+    startConfigPortalNonBlocking(_apName != "" ? _apName : getDefaultAPName(),_apPassword);
+    return;
+  }
+
+  // attempt in progress, wait for a terminal status or the connect timeout
+  if(_reconnAttempt){
+    uint8_t status = WiFi_connectStatus();
+    unsigned long timeout = _connectTimeout > 0 ? _connectTimeout : 60000;
+    if(status != WL_CONNECT_FAILED && status != WL_NO_SSID_AVAIL && now - _reconnAttempt < timeout) return;
+    #ifdef WM_DEBUG_LEVEL
+    DEBUG_WM(WM_DEBUG_VERBOSE,F("Reconnect attempt ended:"),getWLStatusString(status));
+    #endif
+    _reconnAttempt = 0;
+    _reconnLast    = now;
+    #ifdef WM_DEBUG_LEVEL
+    DEBUG_WM(WM_DEBUG_VERBOSE,F("Next reconnect in"),(String)_reconnStats.nextMs + " ms");
+    #endif
+    return;
+  }
+
+  if(now - _reconnLast < _reconnStats.nextMs) return;
+
+  _reconnStats.attempts++;
+  #ifdef WM_DEBUG_LEVEL
+  DEBUG_WM(WM_DEBUG_VERBOSE,F("Reconnect attempt #"),(String)_reconnStats.attempts + " offline " + (String)(now - _reconnDown) + " ms");
+  #endif
+  WiFi_registerEvents(); // terminal failures end the attempt early
+  WiFi_connectStatusReset();
+  if(_defaultssid != "") WiFi.begin(_defaultssid.c_str(),_defaultpass.c_str());
+  else WiFi.reconnect();
+
+  _reconnAttempt  = millis();
+  _reconnInterval = std::min(_reconnInterval * 2,_reconnMax);
+  _reconnStats.nextMs = reconnectJitter(_reconnInterval);
+}
+
+/**
+ * spread an interval by +/- jitter percent
+ * @since $dev
+ * @param  unsigned long interval ms
+ * @return unsigned long ms
+ */
+unsigned long WiFiManager::reconnectJitter(unsigned long interval){
+  if(!_reconnJitter) return interval;
+  unsigned long spread = interval / 100 * _reconnJitter;
+  return interval - spread + random(spread * 2 + 1);
+}
 
+/**
+ * set autoConnectAsync state, notify callback on change
+ * @since $dev
+ * @param wm_async_state_t state
+ */
+void WiFiManager::asyncConnectState(wm_async_state_t state){
+  if(_asyncState == state) return;
+  _asyncState = state;
   #ifdef WM_DEBUG_LEVEL
-  DEBUG_WM(WM_DEBUG_NOTIFY,F("config portal exiting"));
+  DEBUG_WM(WM_DEBUG_VERBOSE,F("AutoConnect async state:"),(uint8_t)state);
   #endif
-  return result;
+  if(_asyncconnectcallback != NULL){
+    _asyncconnectcallback(state); // @CALLBACK
+  }
+}
+
+/**
+ * get autoConnectAsync state
+ * @since $dev
+ * @access public
+ * @return wm_async_state_t
+ */
+wm_async_state_t WiFiManager::getAsyncState(){
+  return _asyncState;
 }
 
 /**
@@ -831,6 +1894,20 @@ boolean WiFiManager::process(){
     #if defined(WM_MDNS) && defined(ESP8266)
     MDNS.update();
     #endif
+
+    // cached ip lease check
+    if(_dhcpCache) dhcpCacheProcess();
+
+    // non blocking autoconnect
+    if(_asyncState == WM_ASYNC_CONNECTING || _asyncState == WM_ASYNC_RETRYING){
+      asyncConnectProcess();
+      if(_asyncState == WM_ASYNC_CONNECTED) return true;
+    }
+
+    // managed reconnect, not while connecting or in the config portal
+    if(_reconnPolicy && !configPortalActive && !_connecting && _asyncState != WM_ASYNC_CONNECTING && _asyncState != WM_ASYNC_RETRYING){
+      reconnectProcess();
+    }
 	
     if(webPortalActive || (configPortalActive && !_configPortalIsBlocking)){
       // if timed out or abort, break
@@ -846,12 +1923,17 @@ boolean WiFiManager::process(){
           #endif
           _configportaltimeoutcallback();  // @CALLBACK
         }
+        if(_asyncState == WM_ASYNC_PORTAL) asyncConnectState(WM_ASYNC_FAILED);
         return false;
       }
 
       uint8_t state = processConfigPortal(); // state is WL_IDLE or WL_CONNECTED/FAILED
+      if(state == WL_CONNECTED && _asyncState == WM_ASYNC_PORTAL) asyncConnectState(WM_ASYNC_CONNECTED);
       return state == WL_CONNECTED;
     }
+
+    // portal stopped by the sketch
+    if(_asyncState == WM_ASYNC_PORTAL) asyncConnectState(WiFi.status() == WL_CONNECTED ? WM_ASYNC_CONNECTED : WM_ASYNC_FAILED);
     return false;
 }
 
@@ -871,6 +1953,9 @@ uint8_t WiFiManager::processConfigPortal(){
     //HTTP handler
     server->handleClient();
 
+    WiFi_scanPoll();
+    backgroundScan();
+
     // Waiting for save...
     if(connect) {
       connect = false;
@@ -888,7 +1973,15 @@ uint8_t WiFiManager::processConfigPortal(){
       else{
         // attempt sta connection to submitted _ssid, _pass
         uint8_t res = connectWifi(_ssid, _pass, _connectonsave) == WL_CONNECTED;
+        _saveConx.channel = 0; // first connect only
+        if(res){
+          _saveConnectMs = millis() - _saveStart;
+          #ifdef WM_DEBUG_LEVEL
+          DEBUG_WM(WM_DEBUG_VERBOSE,F("Save to connected in"),(String)_saveConnectMs + " ms");
+          #endif
+        }
         if (res || (!_connectonsave)) {
+          if(_credStore) credAdd(_ssid.c_str(),_pass.c_str(),res);
           #ifdef WM_DEBUG_LEVEL
           if(!_connectonsave){
             DEBUG_WM(F("SAVED with no connect to new AP"));
@@ -1007,6 +2100,10 @@ bool WiFiManager::shutdownConfigPortal(){
   DEBUG_WM(WM_DEBUG_VERBOSE,F("wifi mode:"),getModeString(WiFi.getMode()));
   #endif
   configPortalActive = false;
+  if(_configPortalBlockingRestore){
+    _configPortalIsBlocking      = _configPortalBlockingUser; // internal non blocking portal closed
+    _configPortalBlockingRestore = false;
+  }
   DEBUG_WM(WM_DEBUG_VERBOSE,F("configportal closed"));
   _end();
   return ret;
@@ -1015,14 +2112,20 @@ bool WiFiManager::shutdownConfigPortal(){
 // @todo refactor this up into seperate functions
 // one for connecting to flash , one for new client
 // clean up, flow is convoluted, and causes bugs
-uint8_t WiFiManager::connectWifi(String ssid, String pass, bool connect) {
+uint8_t WiFiManager::connectWifi(String ssid, String pass, bool connect, unsigned long timeout, bool persist) {
   #ifdef WM_DEBUG_LEVEL
   DEBUG_WM(WM_DEBUG_VERBOSE,F("Connecting as wifi client..."));
   #endif
   uint8_t retry = 1;
   uint8_t connRes = (uint8_t)WL_NO_SSID_AVAIL;
+  unsigned long start = millis();
+
+  _connecting = true;
+  WiFi_scanWait(); // begin fails if a scan is running
+  WiFi_registerEvents(); // connect waits wake on sta events
 
   setSTAConfig();
+  if(_dhcpCache && !_sta_static_ip) _ipcStats.cached = dhcpCacheApply(ssid == "" ? WiFi_SSID(true) : ssid);
   //@todo catch failures in set_config
   
   // make sure sta is on before `begin` so it does not call enablesta->mode while persistent is ON ( which would save WM AP state to eeprom !)
@@ -1034,6 +2137,36 @@ uint8_t WiFiManager::connectWifi(String ssid, String pass, bool connect) {
   // E (5130) wifi:sta is connecting, return error
   // [E][WiFiSTA.cpp:221] begin(): connect failed!
 
+  // fast reconnect, first try the cached bssid and channel, skips the sdk all channel scan
+  if(_fastConnect && connect && wifiConnectFast(ssid,pass,persist)){
+    connRes = waitForConnectResult(_fastConnectTimeout);
+    conxTimelineEnd(connRes);
+    if(connRes != WL_CONNECTED){
+      #ifdef WM_DEBUG_LEVEL
+      DEBUG_WM(F("Fast connect failed, falling back to normal connect"));
+      #endif
+      fastConnectClear();
+      WiFi_Disconnect();
+      // begin with explicit credentials clears the bssid lock from the sta config
+      if(ssid == ""){
+        ssid = WiFi_SSID(true);
+        pass = WiFi_psk(true);
+      }
+    }
+  }
+
+  // portal save, first try the bssid and channel from the portal scan, skips the sdk all channel scan
+  if(connRes != WL_CONNECTED && connect && persist && wifiConnectSaved(ssid,pass)){
+    connRes = waitForConnectResult(timeout > 0 ? timeout : _saveTimeout > 0 ? _saveTimeout : _connectTimeout);
+    conxTimelineEnd(connRes);
+    if(connRes != WL_CONNECTED){
+      #ifdef WM_DEBUG_LEVEL
+      DEBUG_WM(F("Scan informed connect failed, falling back to normal connect"));
+      #endif
+      WiFi_Disconnect();
+    }
+  }
+
   while(retry <= _connectRetries && (connRes!=WL_CONNECTED)){
   if(_connectRetries > 1){
     if(_aggresiveReconn) delay(1000); // add idle time before recon
@@ -1044,23 +2177,30 @@ uint8_t WiFiManager::connectWifi(String ssid, String pass, bool connect) {
   // if ssid argument provided connect to that
   // NOTE: this also catches preload() _defaultssid @todo rework
   if (ssid != "") {
-    wifiConnectNew(ssid,pass,connect);
+    conxTimelineStart(retry);
+    wifiConnectNew(ssid,pass,connect,persist);
     // @todo connect=false seems to disconnect sta in begin() so not sure if _connectonsave is useful at all
     // skip wait if not connecting
     // if(connect){
-      if(_saveTimeout > 0){
+      if(timeout > 0){
+        connRes = waitForConnectResult(timeout); // caller timeout, credential store candidates
+      }
+      else if(_saveTimeout > 0){
         connRes = waitForConnectResult(_saveTimeout); // use default save timeout for saves to prevent bugs in esp->waitforconnectresult loop
       }
       else {
          connRes = waitForConnectResult();
       }
     // }
+    conxTimelineEnd(connRes);
   }
   else {
     // connect using saved ssid if there is one
     if (WiFi_hasAutoConnect()) {
+      conxTimelineStart(retry);
       wifiConnectDefault();
-      connRes = waitForConnectResult();
+      connRes = timeout > 0 ? waitForConnectResult(timeout) : waitForConnectResult();
+      conxTimelineEnd(connRes);
     }
     else {
       #ifdef WM_DEBUG_LEVEL
@@ -1090,18 +2230,115 @@ uint8_t WiFiManager::connectWifi(String ssid, String pass, bool connect) {
     updateConxResult(connRes);
   }
 
+  if(_fastConnect && connRes == WL_CONNECTED) fastConnectSave();
+  if(_dhcpCache && !_sta_static_ip && connRes == WL_CONNECTED) dhcpCacheUpdate(millis() - start);
+
+  _connecting = false;
+  return connRes;
+}
+
+/**
+ * connect using the credential store
+ * one scan, visible networks are tried strongest first, the last good network gets a rssi bonus
+ * to avoid flapping between similar aps, invisible networks are skipped except the last good one (hidden ssid)
+ * @since $dev
+ * @return uint8_t WL Status
+ */
+uint8_t WiFiManager::connectCredentials(){
+  WiFi_scanNetworks(true,false); // one sync scan for all candidates
+
+  struct candidate { uint8_t idx; int32_t rank; };
+  std::vector<candidate> candidates;
+  for(uint8_t i=0; i<_creds->count; i++){
+    const wm_credential_t &cred = _creds->entries[i];
+    bool last = cred.lastok && cred.lastok == _creds->seq;
+    int n     = WiFi_scanFind(cred.ssid);
+    if(n < 0 && (!last || _scanGate)){
+      #ifdef WM_DEBUG_LEVEL
+      DEBUG_WM(WM_DEBUG_VERBOSE,F("Credential not in range, skipping:"),cred.ssid);
+      #endif
+      continue;
+    }
+    // visible by rssi (+10 for last good), invisible last good goes last
+    int32_t rank = n < 0 ? -1000 : WiFi.RSSI(n) + (last ? 10 : 0);
+    candidates.push_back({i,rank});
+  }
+  std::stable_sort(candidates.begin(),candidates.end(),[this](const candidate &a, const candidate &b){
+    if(a.rank != b.rank) return a.rank > b.rank;
+    return _creds->entries[a.idx].lastok > _creds->entries[b.idx].lastok;
+  });
+
+  uint8_t connRes = (uint8_t)WL_NO_SSID_AVAIL;
+  for(const candidate &c : candidates){
+    const wm_credential_t &cred = _creds->entries[c.idx];
+    #ifdef WM_DEBUG_LEVEL
+    DEBUG_WM(F("Trying stored network:"),(String)cred.ssid + " rank:" + (String)c.rank);
+    #endif
+    connRes = connectWifi(cred.ssid,cred.pass,true,_credTimeout,false); // the store keeps the networks, not the sdk config
+    if(connRes == WL_CONNECTED){
+      credAdd(cred.ssid,cred.pass,true);
+      break;
+    }
+  }
   return connRes;
 }
 
+/**
+ * scan gate, check a network is in range before connecting
+ * uses the last portal scan if still cached, else a directed scan on the fast connect channel, then all channels
+ * hidden networks only answer directed scans, a cached scan miss is not trusted,
+ * without a scan filter (WM_NOSCANFILTER) any hidden ap in range lets the connect through
+ * @since $dev
+ * @param  String ssid
+ * @return bool   in range, true if unknown
+ */
+bool WiFiManager::connectScanGate(const String &ssid){
+  if(ssid == "") return true; // nothing saved, let connect report it
+  unsigned long start = millis();
+  int found = -1;
+
+  if(_lastscan > 0 && !_scanTargeted && millis() - _lastscan < _scancachetime){
+    found = WiFi_scanFind(ssid);
+    #ifdef WM_DEBUG_LEVEL
+    DEBUG_WM(WM_DEBUG_VERBOSE,F("Scan gate, using cached scan"));
+    #endif
+  }
+  if(found < 0){
+    uint8_t channel = fastConnectLoad() && _rtc.conx.ssidcrc == wm_crc32(ssid.c_str(),ssid.length()) ? _rtc.conx.channel : 0;
+    if(channel > 0 && channel <= 14) found = WiFi_scanForSSID(ssid,WM_SCAN_CHANNEL(channel));
+    if(found < 0) found = WiFi_scanForSSID(ssid); // moved channel or no cache
+  }
+
+  if(found >= 0) return true;
+
+  #ifdef WM_NOSCANFILTER
+  if(WiFi_scanHasHidden()){
+    #ifdef WM_DEBUG_LEVEL
+    DEBUG_WM(WM_DEBUG_VERBOSE,F("Scan gate, hidden AP in range, connecting:"),ssid);
+    #endif
+    return true; // full scan only, saved network may be hidden
+  }
+  #endif
+
+  #ifdef WM_DEBUG_LEVEL
+  // connect would have waited out every retry timeout
+  unsigned long timeout = (_connectTimeout > 0 ? _connectTimeout : 60000) * std::max(_connectRetries,(uint8_t)1);
+  DEBUG_WM(F("Scan gate, AP not in range, skipping connect:"),ssid);
+  DEBUG_WM(WM_DEBUG_VERBOSE,F("Scan gate, saved ms:"),(String)(timeout - std::min(timeout,millis() - start)) + " scan " + (String)(millis() - start) + " ms");
+  #endif
+  return false;
+}
+
 /**
  * connect to a new wifi ap
  * @since $dev
  * @param  String ssid 
  * @param  String pass 
+ * @param  bool   connect, only save if false
+ * @param  bool   persist, save credentials to the sdk config
  * @return bool success
- * @return connect only save if false
  */
-bool WiFiManager::wifiConnectNew(String ssid, String pass,bool connect){
+bool WiFiManager::wifiConnectNew(String ssid, String pass,bool connect,bool persist){
   bool ret = false;
   #ifdef WM_DEBUG_LEVEL
   // DEBUG_WM(WM_DEBUG_DEV,F("CONNECTED: "),WiFi.status() == WL_CONNECTED ? "Y" : "NO");
@@ -1109,9 +2346,17 @@ bool WiFiManager::wifiConnectNew(String ssid, String pass,bool connect){
   DEBUG_WM(WM_DEBUG_DEV,F("Using Password:"),pass);
   #endif
   WiFi_enableSTA(true,storeSTAmode); // storeSTAmode will also toggle STA on in default opmode (persistent) if true (default)
-  WiFi.persistent(true);
+  if(_conxCur) _conxCur->mode = millis();
+  if(persist) WiFi.persistent(true);
+  #ifdef ESP32
+  else esp_wifi_set_storage(WIFI_STORAGE_RAM); // do not overwrite the saved network
+  #endif
   ret = WiFi.begin(ssid.c_str(), pass.c_str(), 0, NULL, connect);
   WiFi.persistent(false);
+  #ifdef ESP32
+  if(!persist && _userpersistent) esp_wifi_set_storage(WIFI_STORAGE_FLASH);
+  #endif
+  if(_conxCur) _conxCur->begin = millis();
   #ifdef WM_DEBUG_LEVEL
   if(!ret) DEBUG_WM(WM_DEBUG_ERROR,F("[ERROR] wifi begin failed"));
   #endif
@@ -1132,7 +2377,12 @@ bool WiFiManager::wifiConnectDefault(){
   #endif
 
   ret = WiFi_enableSTA(true,storeSTAmode);
+  #ifdef ESP32
+  waitFor([](){ return (WiFi.getStatusBits() & STA_STARTED_BIT) != 0; },500,WM_WAIT_STAMODE); // sta start event
+  #else
   delay(500); // THIS DELAY ?
+  #endif
+  if(_conxCur) _conxCur->mode = millis();
 
   #ifdef WM_DEBUG_LEVEL
   DEBUG_WM(WM_DEBUG_DEV,F("Mode after delay: "),getModeString(WiFi.getMode()));
@@ -1140,6 +2390,7 @@ bool WiFiManager::wifiConnectDefault(){
   #endif
 
   ret = WiFi.begin();
+  if(_conxCur) _conxCur->begin = millis();
 
   #ifdef WM_DEBUG_LEVEL
   if(!ret) DEBUG_WM(WM_DEBUG_ERROR,F("[ERROR] wifi begin failed"));
@@ -1148,6 +2399,376 @@ bool WiFiManager::wifiConnectDefault(){
   return ret;
 }
 
+/**
+ * start recording a connect attempt timeline
+ * @since $dev
+ * @param uint8_t attempt number, 0 for fast connect
+ */
+void WiFiManager::conxTimelineStart(uint8_t attempt){
+  WiFi_connectStatusReset(); // every attempt starts its timeline before begin
+  _conxCur = &_conxTimeline[_conxTimelineIdx];
+  memset(_conxCur,0,sizeof(wm_conx_timeline_t));
+  _conxCur->start    = millis();
+  _conxCur->attempt  = attempt;
+  _conxCur->cachedip = _ipcStats.cached;
+}
+
+/**
+ * finish a connect attempt timeline, add it to the history
+ * @since $dev
+ * @param uint8_t result wl status
+ */
+void WiFiManager::conxTimelineEnd(uint8_t result){
+  if(!_conxCur) return;
+  wm_conx_timeline_t *tl = _conxCur;
+  _conxCur    = nullptr; // stop event updates
+  tl->end     = millis();
+  tl->result  = result;
+  _conxTimelineIdx = (_conxTimelineIdx + 1) % WM_CONX_HISTORY;
+  if(_conxTimelineCount < WM_CONX_HISTORY) _conxTimelineCount++;
+
+  #ifdef WM_DEBUG_LEVEL
+  DEBUG_WM(WM_DEBUG_VERBOSE,F("Connect timeline ms, begin:"),(String)(tl->begin ? tl->begin - tl->start : 0) +
+    " assoc:" + (String)(tl->assoc ? tl->assoc - tl->start : 0) +
+    " ip:" + (String)(tl->gotip ? tl->gotip - tl->start : 0) +
+    " end:" + (String)(tl->end - tl->start) + " reason:" + (String)tl->reason);
+  #endif
+}
+
+/**
+ * connect using the cached bssid and channel of the last good connection
+ * skips the sdk scan, the bssid lock is not persisted
+ * explicit credentials that differ from the saved ones are persisted first, unless persist is false
+ * @since $dev
+ * @param  String ssid, empty for saved
+ * @param  String pass
+ * @param  bool   persist, save explicit credentials to the sdk config
+ * @return bool   false if there is no cache entry for this ssid
+ */
+bool WiFiManager::wifiConnectFast(String ssid, String pass, bool persist){
+  if(ssid == ""){
+    ssid    = WiFi_SSID(true);
+    pass    = WiFi_psk(true);
+    persist = false;
+  }
+  else persist = persist && (ssid != WiFi_SSID(true) || pass != WiFi_psk(true));
+  if(ssid == "" || !fastConnectLoad()) return false;
+  if(_rtc.conx.ssidcrc != wm_crc32(ssid.c_str(),ssid.length())) return false;
+
+  #ifdef WM_DEBUG_LEVEL
+  char bssid[18];
+  snprintf(bssid,sizeof(bssid),"%02X:%02X:%02X:%02X:%02X:%02X",_rtc.conx.bssid[0],_rtc.conx.bssid[1],_rtc.conx.bssid[2],_rtc.conx.bssid[3],_rtc.conx.bssid[4],_rtc.conx.bssid[5]);
+  DEBUG_WM(F("Fast connect to:"),ssid + " " + (String)bssid + " ch:" + (String)_rtc.conx.channel);
+  #endif
+
+  conxTimelineStart(0);
+  WiFi_enableSTA(true,storeSTAmode);
+  if(_conxCur) _conxCur->mode = millis();
+  if(persist){
+    WiFi.persistent(true);
+    WiFi.begin(ssid.c_str(), pass.c_str(), 0, NULL, false); // save credentials only
+    WiFi.persistent(false);
+  }
+  #ifdef ESP32
+  esp_wifi_set_storage(WIFI_STORAGE_RAM); // do not persist the bssid lock
+  #endif
+  bool ret = WiFi.begin(ssid.c_str(), pass.c_str(), _rtc.conx.channel, _rtc.conx.bssid, true);
+  #ifdef ESP32
+  if(_userpersistent) esp_wifi_set_storage(WIFI_STORAGE_FLASH);
+  #endif
+  if(_conxCur) _conxCur->begin = millis();
+
+  if(!ret){
+    #ifdef WM_DEBUG_LEVEL
+    DEBUG_WM(WM_DEBUG_ERROR,F("[ERROR] wifi begin failed"));
+    #endif
+    conxTimelineEnd(WL_CONNECT_FAILED); // caller only closes the timeline of attempts that ran
+  }
+  return ret;
+}
+
+/**
+ * connect to credentials just saved in the portal, on the bssid and channel the portal scan found
+ * the credentials are saved without the bssid lock, the locked begin is not persisted
+ * @since $dev
+ * @param  String ssid
+ * @param  String pass
+ * @return bool   attempted
+ */
+bool WiFiManager::wifiConnectSaved(String ssid, String pass){
+  if(ssid == "" || _saveConx.channel == 0 || _saveConx.ssidcrc != wm_crc32(ssid.c_str(),ssid.length())) return false;
+  uint8_t channel = _saveConx.channel;
+  _saveConx.channel = 0; // one attempt
+
+  #ifdef WM_DEBUG_LEVEL
+  DEBUG_WM(F("Connecting to NEW AP from scan:"),ssid + " ch:" + (String)channel);
+  #endif
+
+  conxTimelineStart(0);
+  WiFi_enableSTA(true,storeSTAmode);
+  if(_conxCur) _conxCur->mode = millis();
+  WiFi.persistent(true);
+  WiFi.begin(ssid.c_str(), pass.c_str(), 0, NULL, false); // save credentials only
+  WiFi.persistent(false);
+  #ifdef ESP32
+  esp_wifi_set_storage(WIFI_STORAGE_RAM); // do not persist the bssid lock
+  #endif
+  bool ret = WiFi.begin(ssid.c_str(), pass.c_str(), channel, _saveConx.bssid, true);
+  #ifdef ESP32
+  if(_userpersistent) esp_wifi_set_storage(WIFI_STORAGE_FLASH);
+  #endif
+  if(_conxCur) _conxCur->begin = millis();
+
+  if(!ret){
+    #ifdef WM_DEBUG_LEVEL
+    DEBUG_WM(WM_DEBUG_ERROR,F("[ERROR] wifi begin failed"));
+    #endif
+    conxTimelineEnd(WL_CONNECT_FAILED); // caller only closes the timeline of attempts that ran
+  }
+  return ret;
+}
+
+/**
+ * load fast connect cache, from rtc or flash store
+ * @since $dev
+ * @return bool cache entry available
+ */
+bool WiFiManager::fastConnectLoad(){
+  rtcLoad();
+  if(_rtc.conx.channel == 0){
+    if(storeRead("conx",&_rtc.conx,sizeof(_rtc.conx))) rtcSave(); // copy to rtc for the next wake
+    else memset(&_rtc.conx,0,sizeof(_rtc.conx));
+  }
+  return _rtc.conx.channel != 0;
+}
+
+/**
+ * cache current connection bssid and channel, only written when changed
+ * @since $dev
+ */
+void WiFiManager::fastConnectSave(){
+  wm_fastconx_t conx;
+  memset(&conx,0,sizeof(conx));
+  String ssid  = WiFi.SSID();
+  uint8_t *bssid = WiFi.BSSID();
+  conx.ssidcrc = wm_crc32(ssid.c_str(),ssid.length());
+  conx.channel = WiFi.channel();
+  if(bssid) memcpy(conx.bssid,bssid,sizeof(conx.bssid));
+
+  fastConnectLoad();
+  if(memcmp(&conx,&_rtc.conx,sizeof(conx)) == 0) return; // unchanged, no rtc or flash writes
+  #ifdef WM_DEBUG_LEVEL
+  DEBUG_WM(WM_DEBUG_VERBOSE,F("Fast connect cache updated, ch:"),conx.channel);
+  #endif
+  _rtc.conx = conx;
+  rtcSave();
+  storeWrite("conx",&conx,sizeof(conx));
+}
+
+/**
+ * invalidate fast connect cache
+ * @since $dev
+ */
+void WiFiManager::fastConnectClear(){
+  rtcLoad();
+  memset(&_rtc.conx,0,sizeof(_rtc.conx));
+  rtcSave();
+  storeRemove("conx");
+}
+
+/**
+ * load ip cache, from rtc or flash store
+ * @since $dev
+ * @return bool cache entry available
+ */
+bool WiFiManager::dhcpCacheLoad(){
+  rtcLoad();
+  if(_rtc.ipc.ip == 0){
+    if(storeRead("ipc",&_rtc.ipc,sizeof(_rtc.ipc))) rtcSave();
+    else memset(&_rtc.ipc,0,sizeof(_rtc.ipc));
+  }
+  return _rtc.ipc.ip != 0;
+}
+
+/**
+ * apply cached dhcp ip config as provisional static config
+ * skips dhcp on connect, confirmed by a dhcp lease after connect, see dhcpCacheUpdate
+ * @since $dev
+ * @param  String ssid connecting to
+ * @return bool   applied
+ */
+bool WiFiManager::dhcpCacheApply(const String &ssid){
+  dhcpCacheProcess(); // finish the previous connects lease check
+  _ipcConfirm = 0;
+  bool apply = dhcpCacheLoad() && _rtc.ipc.ssidcrc == wm_crc32(ssid.c_str(),ssid.length()) && _rtc.ipc.uses < _dhcpCacheMaxUses;
+  if(!apply){
+    if(_ipcStats.cached) WiFi.config(IPAddress(),IPAddress(),IPAddress()); // drop previous provisional config, back to dhcp
+    return false;
+  }
+  #ifdef WM_DEBUG_LEVEL
+  DEBUG_WM(F("Using cached IP:"),IPAddress(_rtc.ipc.ip));
+  #endif
+  bool ret = WiFi.config(IPAddress(_rtc.ipc.ip),IPAddress(_rtc.ipc.gw),IPAddress(_rtc.ipc.sn),IPAddress(_rtc.ipc.dns));
+  #ifdef WM_DEBUG_LEVEL
+  if(!ret) DEBUG_WM(WM_DEBUG_ERROR,F("[ERROR] wifi config failed"));
+  #endif
+  return ret;
+}
+
+/**
+ * after connect, confirm the cached ip config or record the dhcp lease
+ * on a cached config dhcp is restarted in the background on the live connection,
+ * the lease is compared in dhcpCacheLease, if the ap changed the cache is dropped
+ * @since $dev
+ * @param unsigned long connectms connect time
+ */
+void WiFiManager::dhcpCacheUpdate(unsigned long connectms){
+  _ipcStats.connectMs = connectms;
+
+  if(_ipcStats.cached){
+    String ssid     = WiFi.SSID();
+    uint8_t *bssid  = WiFi.BSSID();
+    _ipcStats.valid  = false; // until a lease confirms it
+    _ipcStats.dhcpMs = _rtc.ipc.dhcpms;
+    if(_rtc.ipc.ssidcrc == wm_crc32(ssid.c_str(),ssid.length()) && bssid && memcmp(_rtc.ipc.bssid,bssid,sizeof(_rtc.ipc.bssid)) == 0){
+      #ifdef WM_DEBUG_LEVEL
+      DEBUG_WM(F("Cached IP connected in"),(String)connectms + " ms, dhcp " + (String)_rtc.ipc.dhcpms + " ms, confirming lease");
+      #endif
+      WiFi_registerEvents();
+      WiFi.config(IPAddress(),IPAddress(),IPAddress()); // dhcp in the background on the live connection
+      #ifdef ESP32
+      _ipcLease   = false;
+      #endif
+      _ipcConfirm = millis() | 1; // non zero, after the restart so the static config got ip is ignored
+    }
+    else {
+      #ifdef WM_DEBUG_LEVEL
+      DEBUG_WM(F("Cached IP network changed, falling back to DHCP"));
+      #endif
+      dhcpCacheClear();
+      WiFi.config(IPAddress(),IPAddress(),IPAddress());
+    }
+    return;
+  }
+
+  // dhcp connect, record the lease
+  if(!dhcpCacheRecord(connectms)) return;
+  _ipcStats.valid  = true;
+  _ipcStats.uses   = 0;
+  _ipcStats.dhcpMs = connectms;
+  if(_ipcDirty){
+    _ipcDirty = false;
+    storeWrite("ipc",&_rtc.ipc,sizeof(_rtc.ipc)); // flash only on lease change
+  }
+}
+
+/**
+ * record the current dhcp lease in the rtc cache, marks a flash write pending if it changed
+ * no flash writes
+ * @since $dev
+ * @param  unsigned long dhcpms connect time of the dhcp connect
+ * @return bool lease recorded
+ */
+bool WiFiManager::dhcpCacheRecord(unsigned long dhcpms){
+  String ssid     = WiFi.SSID();
+  uint8_t *bssid  = WiFi.BSSID();
+  wm_ipcache_t ipc;
+  memset(&ipc,0,sizeof(ipc));
+  ipc.ssidcrc = wm_crc32(ssid.c_str(),ssid.length());
+  if(bssid) memcpy(ipc.bssid,bssid,sizeof(ipc.bssid));
+  ipc.ip      = WiFi.localIP();
+  ipc.gw      = WiFi.gatewayIP();
+  ipc.sn      = WiFi.subnetMask();
+  ipc.dns     = WiFi.dnsIP();
+  ipc.dhcpms  = dhcpms;
+  if(ipc.ip == 0) return false;
+
+  dhcpCacheLoad();
+  bool changed = ipc.ssidcrc != _rtc.ipc.ssidcrc || memcmp(ipc.bssid,_rtc.ipc.bssid,sizeof(ipc.bssid)) != 0 ||
+                 ipc.ip != _rtc.ipc.ip || ipc.gw != _rtc.ipc.gw || ipc.sn != _rtc.ipc.sn || ipc.dns != _rtc.ipc.dns;
+  _rtc.ipc = ipc;
+  rtcSave();
+  if(changed) _ipcDirty = true;
+  #ifdef WM_DEBUG_LEVEL
+  DEBUG_WM(WM_DEBUG_VERBOSE,F("DHCP IP cached:"),WiFi.localIP());
+  #endif
+  return true;
+}
+
+/**
+ * dhcp lease after a cached ip connect, confirms the cached config or replaces it
+ * called from dhcpCacheProcess, esp32 lease copied by the got ip event, esp8266 polled
+ * @since $dev
+ * @param uint32_t ip, gw, sn lease
+ */
+void WiFiManager::dhcpCacheLease(uint32_t ip, uint32_t gw, uint32_t sn){
+  if(!_ipcConfirm || ip == 0) return; // not bound yet
+  _ipcConfirm = 0;
+  _ipcStats.valid = ip == _rtc.ipc.ip && gw == _rtc.ipc.gw && sn == _rtc.ipc.sn;
+  if(_ipcStats.valid){
+    _rtc.ipc.uses++;
+    rtcSave();
+    _ipcStats.uses = _rtc.ipc.uses;
+    #ifdef WM_DEBUG_LEVEL
+    DEBUG_WM(F("Cached IP confirmed by DHCP lease"));
+    #endif
+    return;
+  }
+  #ifdef WM_DEBUG_LEVEL
+  DEBUG_WM(F("DHCP lease differs from cached IP, replacing cache:"),IPAddress(ip));
+  #endif
+  dhcpCacheRecord(_rtc.ipc.dhcpms);
+  _ipcStats.uses = 0;
+}
+
+/**
+ * cached ip lease check, flash writes for event side cache changes, lease timeout
+ * @since $dev
+ */
+void WiFiManager::dhcpCacheProcess(){
+  #ifdef ESP32
+  if(_ipcLease){
+    _ipcLease = false;
+    dhcpCacheLease(_ipcLeaseIp,_ipcLeaseGw,_ipcLeaseSn);
+  }
+  #elif defined(ESP8266)
+  if(_ipcConfirm){
+    #if LWIP_VERSION_MAJOR == 1
+    bool bound = netif_default && netif_default->dhcp && netif_default->dhcp->state == DHCP_BOUND;
+    #else
+    bool bound = netif_default && dhcp_supplied_address(netif_default);
+    #endif
+    if(bound) dhcpCacheLease(WiFi.localIP(),WiFi.gatewayIP(),WiFi.subnetMask());
+  }
+  #endif
+
+  if(_ipcConfirm && millis() - _ipcConfirm > WM_DHCP_CONFIRM_TIMEOUT){
+    _ipcConfirm = 0;
+    #ifdef WM_DEBUG_LEVEL
+    DEBUG_WM(F("No DHCP lease for cached IP, dropping cache"));
+    #endif
+    dhcpCacheClear();
+    _ipcDirty = false;
+    return;
+  }
+
+  if(_ipcDirty){
+    _ipcDirty = false;
+    storeWrite("ipc",&_rtc.ipc,sizeof(_rtc.ipc));
+  }
+}
+
+/**
+ * invalidate ip cache
+ * @since $dev
+ */
+void WiFiManager::dhcpCacheClear(){
+  rtcLoad();
+  memset(&_rtc.ipc,0,sizeof(_rtc.ipc));
+  rtcSave();
+  storeRemove("ipc");
+}
+
 
 /**
  * set sta config if set
@@ -1224,34 +2845,46 @@ uint8_t WiFiManager::waitForConnectResult() {
 
 /**
  * waitForConnectResult
- * @param  uint16_t timeout  in seconds
+ * event driven, esp32 wakes on sta events, esp8266 polls station status
+ * returns early on connect and on terminal failures, wrong password, ap not found
+ * @param  uint16_t timeout  in ms, 0 for esp default 60s
  * @return uint8_t  WL Status
  */
 uint8_t WiFiManager::waitForConnectResult(uint32_t timeout) {
   if (timeout == 0){
     #ifdef WM_DEBUG_LEVEL
-    DEBUG_WM(F("connectTimeout not set, ESP waitForConnectResult..."));
+    DEBUG_WM(F("connectTimeout not set, using 60s"));
     #endif
-    return WiFi.waitForConnectResult();
+    timeout = 60000; // same as esp waitForConnectResult
   }
 
-  unsigned long timeoutmillis = millis() + timeout;
+  unsigned long start = millis();
   #ifdef WM_DEBUG_LEVEL
   DEBUG_WM(WM_DEBUG_VERBOSE,timeout,F("ms timeout, waiting for connect..."));
   #endif
   uint8_t status = WiFi.status();
-  
-  while(millis() < timeoutmillis) {
-    status = WiFi.status();
+
+  while(millis() - start < timeout) {
+    status = WiFi_connectStatus();
     // @todo detect additional states, connect happens, then dhcp then get ip, there is some delay here, make sure not to timeout if waiting on IP
-    if (status == WL_CONNECTED || status == WL_CONNECT_FAILED) {
-      return status;
+    if (status == WL_CONNECTED || status == WL_CONNECT_FAILED || status == WL_NO_SSID_AVAIL) {
+      break;
     }
-    #ifdef WM_DEBUG_LEVEL
-    DEBUG_WM (WM_DEBUG_VERBOSE,F("."));
+
+    #ifdef ESP8266
+    delay(10);
+    #elif defined(ESP32)
+    unsigned long elapsed = millis() - start;
+    if(elapsed >= timeout) break;
+    if(_conxEvent) xSemaphoreTake(_conxEvent,pdMS_TO_TICKS(timeout - elapsed));
+    else delay(10);
     #endif
-    delay(100);
   }
+
+  #ifdef WM_DEBUG_LEVEL
+  if(status != WL_CONNECTED) DEBUG_WM(WM_DEBUG_VERBOSE,F("connect wait ended:"),getWLStatusString(status));
+  DEBUG_WM(WM_DEBUG_VERBOSE,F("connect wait ms:"),millis() - start);
+  #endif
   return status;
 }
 
@@ -1278,7 +2911,8 @@ String WiFiManager::getHTTPHead(String title, String classes){
   page.replace(FPSTR(T_v), title);
   page += FPSTR(HTTP_SCRIPT);
   page += FPSTR(HTTP_STYLE);
-  page += _customHeadElement;
+  if(_customHeadElementP) page += FPSTR(_customHeadElement);
+  else page += _customHeadElement;
 
   String p = FPSTR(HTTP_HEAD_END);
   if (_bodyClass != "") {
@@ -1291,7 +2925,8 @@ String WiFiManager::getHTTPHead(String title, String classes){
   page += p;
 
   if (_customBodyHeader) {
-    page += _customBodyHeader;
+    if(_customBodyHeaderP) page += FPSTR(_customBodyHeader);
+    else page += _customBodyHeader;
   }
 
   return page;
@@ -1301,7 +2936,7 @@ String WiFiManager::getHTTPEnd() {
   String end = FPSTR(HTTP_END);
 
   if (_customBodyFooter) {
-    end = String(_customBodyFooter) + end;
+    end = (_customBodyFooterP ? String(FPSTR(_customBodyFooter)) : String(_customBodyFooter)) + end;
   }
 
   return end;
@@ -1317,6 +2952,21 @@ void WiFiManager::HTTPSend(const String &content){
 void WiFiManager::handleRequest() {
   _webPortalAccessed = millis();
 
+  // portal ready metric, first request served since start
+  if(_portalStartMs && !_portalReadyMs){
+    _portalReadyMs = _webPortalAccessed - _portalStartMs;
+    if(!_portalReadyMs) _portalReadyMs = 1;
+    #ifdef WM_DEBUG_LEVEL
+    DEBUG_WM(WM_DEBUG_VERBOSE,F("Portal ready, first request ms:"),_portalReadyMs);
+    #endif
+  }
+
+  // client is back, reset background scan backoff
+  if(_bgscan && _bgscanBackoff > _bgscanInterval){
+    _bgscanBackoff = 0;
+    _bgscanNext    = _webPortalAccessed;
+  }
+
   // TESTING HTTPD AUTH RFC 2617
   // BASIC_AUTH will hold onto creds, hard to "logout", but convienent
   // DIGEST_AUTH will require new auth often, and nonce is random
@@ -1358,7 +3008,8 @@ void WiFiManager::handleRoot() {
   page += getHTTPEnd();
 
   HTTPSend(page);
-  if(_preloadwifiscan) WiFi_scanNetworks(_scancachetime,true); // preload wifiscan throttled, async
+  if(_bgscan) WiFi_scanRequest(false); // stale results only, async
+  else if(_preloadwifiscan) WiFi_scanNetworks(_scancachetime,true); // preload wifiscan throttled, async
   // @todo buggy, captive portals make a query on every page load, causing this to run every time in addition to the real page load
   // I dont understand why, when you are already in the captive portal, I guess they want to know that its still up and not done or gone
   // if we can detect these and ignore them that would be great, since they come from the captive portal redirect maybe there is a refferer
@@ -1377,8 +3028,23 @@ void WiFiManager::handleWifi(boolean scan) {
     #ifdef WM_DEBUG_LEVEL
     // DEBUG_WM(WM_DEBUG_DEV,"refresh flag:",server->hasArg(F("refresh")));
     #endif
-    WiFi_scanNetworks(server->hasArg(F("refresh")),false); //wifiscan, force if arg refresh
-    page += getScanItemOut();
+    if(_bgscan) WiFi_scanRequest(server->hasArg(F("refresh"))); // scheduler, never scan in the handler, serve cached
+    else WiFi_scanNetworks(server->hasArg(F("refresh")),false); //wifiscan, force if arg refresh
+    if(_scanPageSize > 0){
+      // first page only, more pages and search are fetched from /wifiscan
+      int next = 0;
+      page += FPSTR(HTTP_SCAN_JS);
+      page += FPSTR(HTTP_SCAN_SEARCH);
+      page += F("<div id='sl'>");
+      page += getScanItemOut(0,"",&next);
+      page += F("</div>");
+      String more = FPSTR(HTTP_SCAN_MORE);
+      more.replace(FPSTR(T_v),(String)next);
+      more.replace(FPSTR(T_h),next ? "" : "h");
+      page += more;
+      page += FPSTR(HTTP_BR);
+    }
+    else page += getScanItemOut();
   }
   String pitem = "";
 
@@ -1408,6 +3074,7 @@ void WiFiManager::handleWifi(boolean scan) {
     page += getParamOut();
   }
   page += FPSTR(HTTP_FORM_END);
+  if(_paramsInWifi && _paramsCount>0) page += getParamSectionsOut();
   page += FPSTR(HTTP_SCAN_LINK);
   if(_showBack) page += FPSTR(HTTP_BACKBTN);
   reportStatus(page);
@@ -1420,6 +3087,52 @@ void WiFiManager::handleWifi(boolean scan) {
   #endif
 }
 
+/**
+ * HTTPD CALLBACK Wifi scan list page, html fragment of cached scan results
+ * ?page= page number, ?q= ssid prefix search, next page in X-Page-Next header
+ */
+void WiFiManager::handleWifiScan(){
+  #ifdef WM_DEBUG_LEVEL
+  DEBUG_WM(WM_DEBUG_VERBOSE,F("<- HTTP WifiScan"));
+  #endif
+  handleRequest();
+  if(_bgscan) WiFi_scanRequest(false);
+  else WiFi_scanNetworks(false,false); // cached, unless stale
+  int next   = 0;
+  int page   = std::max(0,(int)server->arg(F("page")).toInt()); // -1 (all) is internal only
+  String out = getScanItemOut(page,server->arg(F("q")),&next);
+  server->sendHeader(FPSTR(HTTP_HEAD_PAGENEXT),next ? (String)next : "");
+  HTTPSend(out);
+}
+
+/**
+ * HTTPD CALLBACK connect timeline json, newest first, ms offsets from attempt start
+ */
+void WiFiManager::handleConxLog(){
+  #ifdef WM_DEBUG_LEVEL
+  DEBUG_WM(WM_DEBUG_VERBOSE,F("<- HTTP ConxLog"));
+  #endif
+  handleRequest();
+  String out = F("[");
+  wm_conx_timeline_t tl;
+  for(uint8_t i=0; getConnectTimeline(tl,i); i++){
+    if(i) out += ',';
+    out += F("{\"attempt\":");   out += tl.attempt;
+    out += F(",\"mode\":");     out += tl.mode  ? tl.mode  - tl.start : 0;
+    out += F(",\"begin\":");    out += tl.begin ? tl.begin - tl.start : 0;
+    out += F(",\"assoc\":");    out += tl.assoc ? tl.assoc - tl.start : 0;
+    out += F(",\"gotip\":");    out += tl.gotip ? tl.gotip - tl.start : 0;
+    out += F(",\"end\":");      out += tl.end - tl.start;
+    out += F(",\"reason\":");   out += tl.reason;
+    out += F(",\"result\":\""); out += getWLStatusString(tl.result);
+    out += F("\",\"cachedip\":"); out += tl.cachedip ? F("true") : F("false");
+    out += F(",\"age\":");      out += millis() - tl.start;
+    out += '}';
+  }
+  out += ']';
+  server->send(200, FPSTR(HTTP_HEAD_CTJSON), out);
+}
+
 /**
  * HTTPD CALLBACK Wifi param page handler
  */
@@ -1431,13 +3144,27 @@ void WiFiManager::handleParam(){
   String page = getHTTPHead(FPSTR(S_titleparam), FPSTR(C_param)); // @token titlewifi
 
   String pitem = "";
-
-  pitem = FPSTR(HTTP_FORM_START);
-  pitem.replace(FPSTR(T_v), F("paramsave"));
-  page += pitem;
-
-  page += getParamOut();
-  page += FPSTR(HTTP_FORM_END);
+  String section  = server->arg(FPSTR(S_section)); // sub-page, only this section is rendered
+  if(!paramSectionExists(section)) section = "";   // unknown section, main param page
+  String params   = getParamOut(section);
+  String sections = section == "" ? getParamSectionsOut() : "";
+
+  // no form when all parameters are in sections
+  if(params != "" || sections == ""){
+    pitem = FPSTR(HTTP_FORM_START);
+    pitem.replace(FPSTR(T_v), F("paramsave"));
+    page += pitem;
+
+    if(section != ""){
+      pitem = FPSTR(HTTP_FORM_SECTION);
+      pitem.replace(FPSTR(T_t), htmlEntities(section));
+      pitem.replace(FPSTR(T_v), htmlEntities(section));
+      page += pitem;
+    }
+    page += params;
+    page += FPSTR(HTTP_FORM_END);
+  }
+  page += sections;
   if(_showBack) page += FPSTR(HTTP_BACKBTN);
   reportStatus(page);
   page += getHTTPEnd();
@@ -1456,7 +3183,8 @@ String WiFiManager::getMenuOut(){
   for(auto menuId :_menuIds ){
     if((String)_menutokens[menuId] == "param" && _paramsCount == 0) continue; // no params set, omit params from menu, @todo this may be undesired by someone, use only menu to force?
     if((String)_menutokens[menuId] == "custom" && _customMenuHTML!=NULL){
-      page += _customMenuHTML;
+      if(_customMenuHTMLP) page += FPSTR(_customMenuHTML);
+      else page += _customMenuHTML;
       continue;
     }
     page += HTTP_PORTAL_MENU[menuId];
@@ -1473,6 +3201,7 @@ String WiFiManager::getMenuOut(){
 
 void WiFiManager::WiFi_scanComplete(int networksFound){
   _lastscan = millis();
+  _scanDuration = _lastscan - _startscan;
   _numNetworks = networksFound;
   #ifdef WM_DEBUG_LEVEL
   DEBUG_WM(WM_DEBUG_VERBOSE,F("WiFi Scan ASYNC completed"), "in "+(String)(_lastscan - _startscan)+" ms");  
@@ -1505,37 +3234,33 @@ bool WiFiManager::WiFi_scanNetworks(bool force,bool async){
     }
 
     // if scan is empty or stale (last scantime > _scancachetime), this avoids fast reloading wifi page and constant scan delayed page loads appearing to freeze.
-    if(!_lastscan || (_lastscan>0 && (millis()-_lastscan > _scancachetime))){
+    if(!_lastscan || _scanTargeted || (_lastscan>0 && (millis()-_lastscan > _scancachetime))){
       force = true;
     }
 
     if(force){
-      int8_t res;
+      int16_t res;
       _startscan = millis();
+      _scanTargeted = false;
+      // portal scans always cover all channels and ssids
+      wm_scan_opts_t opts = _scanOpts;
+      opts.ssid = nullptr;
+      #ifndef WM_NOASYNC // no async available < 2.4.0
       if(async && _asyncScan){
-        #ifdef ESP8266
-          #ifndef WM_NOASYNC // no async available < 2.4.0
-          #ifdef WM_DEBUG_LEVEL
-          DEBUG_WM(WM_DEBUG_VERBOSE,F("WiFi Scan ASYNC started"));
-          #endif
-          using namespace std::placeholders; // for `_1`
-          WiFi.scanNetworksAsync(std::bind(&WiFiManager::WiFi_scanComplete,this,_1));
-          #else
-          DEBUG_WM(WM_DEBUG_VERBOSE,F("WiFi Scan SYNC started"));
-          res = WiFi.scanNetworks();
-          #endif
-        #else
-        #ifdef WM_DEBUG_LEVEL
-          DEBUG_WM(WM_DEBUG_VERBOSE,F("WiFi Scan ASYNC started"));
-          #endif
-          res = WiFi.scanNetworks(true);
-        #endif
+        // completion is polled in processConfigPortal, WiFi_scanPoll
+        if(!_scanRunning) WiFi_scanStartAsync();
         return false;
       }
-      else{
-        DEBUG_WM(WM_DEBUG_VERBOSE,F("WiFi Scan SYNC started"));
-        res = WiFi.scanNetworks();
+      #endif
+      if(_scanRunning){
+        // async scan already running, its results are fresh
+        WiFi_scanWait();
+        return true;
       }
+      #ifdef WM_DEBUG_LEVEL
+      DEBUG_WM(WM_DEBUG_VERBOSE,F("WiFi Scan SYNC started"));
+      #endif
+      res = WiFi_scanStart(opts,0,false);
       if(res == WIFI_SCAN_FAILED){
         #ifdef WM_DEBUG_LEVEL
         DEBUG_WM(WM_DEBUG_ERROR,F("[ERROR] scan failed"));
@@ -1545,16 +3270,18 @@ bool WiFiManager::WiFi_scanNetworks(bool force,bool async){
         #ifdef WM_DEBUG_LEVEL
         DEBUG_WM(WM_DEBUG_ERROR,F("[ERROR] scan waiting"));
         #endif
-        while(WiFi.scanComplete() == WIFI_SCAN_RUNNING){
+        unsigned long start = millis();
+        while((res = WiFi.scanComplete()) == WIFI_SCAN_RUNNING && millis() - start < WM_SCAN_TIMEOUT){
           #ifdef WM_DEBUG_LEVEL
           DEBUG_WM(WM_DEBUG_ERROR,".");
           #endif
           delay(100);
         }
-        _numNetworks = WiFi.scanComplete();
+        _numNetworks = res > 0 ? res : 0;
       }
       else if(res >=0 ) _numNetworks = res;
       _lastscan = millis();
+      _scanDuration = _lastscan - _startscan;
       #ifdef WM_DEBUG_LEVEL
       DEBUG_WM(WM_DEBUG_VERBOSE,F("WiFi Scan completed"), "in "+(String)(_lastscan - _startscan)+" ms");
       #endif
@@ -1568,8 +3295,317 @@ bool WiFiManager::WiFi_scanNetworks(bool force,bool async){
     return false;
 }
 
-String WiFiManager::WiFiManager::getScanItemOut(){
+/**
+ * wait for a running async scan to finish, bounded
+ * @since $dev
+ */
+void WiFiManager::WiFi_scanWait(){
+  if(!_scanRunning) return;
+  unsigned long start = millis();
+  int16_t res;
+  while((res = WiFi.scanComplete()) == WIFI_SCAN_RUNNING && millis() - start < WM_SCAN_TIMEOUT){
+    delay(10);
+  }
+  _scanRunning = false;
+  WiFi_scanComplete(res > 0 ? res : 0);
+}
+
+/**
+ * start an async full scan, completion is handled by WiFi_scanPoll only
+ * @since $dev
+ * @return bool started
+ */
+bool WiFiManager::WiFi_scanStartAsync(){
+  wm_scan_opts_t opts = _scanOpts;
+  opts.ssid     = nullptr; // portal scans always cover all channels and ssids
+  _startscan    = millis();
+  _scanTargeted = false;
+  _scanRunning  = WiFi_scanStart(opts,0,true) != WIFI_SCAN_FAILED;
+  #ifdef WM_DEBUG_LEVEL
+  DEBUG_WM(WM_DEBUG_VERBOSE,_scanRunning ? F("WiFi Scan ASYNC started") : F("[ERROR] scan failed"));
+  #endif
+  return _scanRunning;
+}
+
+/**
+ * poll a running async scan, the one place async scan completion is processed
+ * called from processConfigPortal, gives up after WM_SCAN_TIMEOUT
+ * @since $dev
+ */
+void WiFiManager::WiFi_scanPoll(){
+  if(!_scanRunning) return;
+  int16_t res = WiFi.scanComplete();
+  if(res == WIFI_SCAN_RUNNING){
+    if(millis() - _startscan < WM_SCAN_TIMEOUT) return;
+    res = WIFI_SCAN_FAILED;
+    #ifdef WM_DEBUG_LEVEL
+    DEBUG_WM(WM_DEBUG_ERROR,F("[ERROR] scan timed out"));
+    #endif
+  }
+  _scanRunning = false;
+  WiFi_scanComplete(res > 0 ? res : 0);
+}
+
+/**
+ * scan request from a http handler with the scheduler on, never blocks
+ * starts an async scan if results are stale (or forced) and none is running, handlers serve the cache
+ * @since $dev
+ * @param bool force refresh requested
+ */
+void WiFiManager::WiFi_scanRequest(bool force){
+  #ifndef WM_NOASYNC
+  if(_scanRunning || _otaInProgress || _connecting || connect) return;
+  if(!force && _lastscan && !_scanTargeted && millis() - _lastscan < _scancachetime) return;
+  if(WiFi_scanStartAsync()) _bgscanNext = millis() + _bgscanInterval;
+  #else
+  WiFi_scanNetworks(force,false); // no async scans on this core
+  #endif
+}
+
+/**
+ * background scan scheduler, called from processConfigPortal
+ * runs async scans every _bgscanInterval while web clients are active,
+ * doubles the interval up to _bgscanMaxInterval while idle, any request resets it
+ * never scans during ota uploads, connects or a pending save
+ * @since $dev
+ */
+void WiFiManager::backgroundScan(){
+  #ifndef WM_NOASYNC
+  if(!_bgscan || _scanRunning) return;
+
+  if(_otaInProgress || _connecting || connect) return;
+
+  unsigned long now = millis();
+  if(_bgscanNext && (long)(now - _bgscanNext) < 0) return;
+
+  bool active = _webPortalAccessed && (now - _webPortalAccessed < _bgscanInterval * 2);
+  if(active || !_bgscanBackoff) _bgscanBackoff = _bgscanInterval;
+  else _bgscanBackoff = std::min(_bgscanBackoff * 2, _bgscanMaxInterval);
+  _bgscanNext = now + _bgscanBackoff;
+
+  WiFi_scanStartAsync();
+
+  #ifdef WM_DEBUG_LEVEL
+  DEBUG_WM(WM_DEBUG_DEV,F("Background scan started, next in"),(String)_bgscanBackoff + " ms");
+  #endif
+  #endif
+}
+
+/**
+ * start a single scan pass with scan options
+ * @since $dev
+ * @param  wm_scan_opts_t opts    scan options, ssid, passive, dwell, hidden
+ * @param  uint8_t        channel channel to scan, 0 for all
+ * @param  bool           async   return immediately, results via scanComplete
+ * @return int16_t        networks found or WIFI_SCAN_RUNNING/WIFI_SCAN_FAILED
+ */
+int16_t WiFiManager::WiFi_scanStart(const wm_scan_opts_t &opts, uint8_t channel, bool async){
+  #ifdef ESP8266
+    // esp8266 scan api has no passive or dwell options
+    #ifdef WM_NOSCANFILTER
+    return WiFi.scanNetworks(async,opts.hidden);
+    #else
+    return WiFi.scanNetworks(async,opts.hidden,channel,(uint8*)opts.ssid);
+    #endif
+  #elif defined(ESP32)
+    uint32_t dwell = opts.dwell > 0 ? opts.dwell : 300; // sdk default max ms per channel
+    #ifdef WM_NOSCANFILTER
+    return WiFi.scanNetworks(async,opts.hidden,opts.passive,dwell);
+    #else
+    return WiFi.scanNetworks(async,opts.hidden,opts.passive,dwell,channel,opts.ssid);
+    #endif
+  #endif
+}
+
+/**
+ * targeted scan, channel list and or directed ssid probe
+ * a directed scan walks the channel list and stops on the first channel the ssid is seen on,
+ * an undirected scan of more than one channel falls back to all channels, sdk scans cannot be merged
+ * results are partial, the next portal scan is forced
+ * @since $dev
+ * @param  wm_scan_opts_t opts scan options
+ * @return bool           networks found
+ */
+bool WiFiManager::WiFi_scanNetworks(const wm_scan_opts_t &opts){
+  int16_t res = WIFI_SCAN_FAILED;
+  WiFi_scanWait(); // finish a running portal scan as a full scan first, its completion is not lost
+  _startscan    = millis();
+  _scanTargeted = true;
+
+  uint8_t numchannels = 0;
+  #ifndef WM_NOSCANFILTER
+  for(uint8_t ch = 1; ch <= 14; ch++){
+    if(opts.channels & WM_SCAN_CHANNEL(ch)) numchannels++;
+  }
+  #endif
+
+  if(numchannels == 0 || (numchannels > 1 && !opts.ssid)){
+    res = WiFi_scanStart(opts,0,false);
+  }
+  else {
+    for(uint8_t ch = 1; ch <= 14; ch++){
+      if(!(opts.channels & WM_SCAN_CHANNEL(ch))) continue;
+      res = WiFi_scanStart(opts,ch,false);
+      _numNetworks = res > 0 ? res : 0;
+      if(!opts.ssid || WiFi_scanFind(opts.ssid) >= 0) break; // found, skip remaining channels
+    }
+  }
+
+  if(res == WIFI_SCAN_RUNNING){
+    // scan started outside wifimanager, use its results, bounded
+    unsigned long start = millis();
+    while((res = WiFi.scanComplete()) == WIFI_SCAN_RUNNING && millis() - start < WM_SCAN_TIMEOUT){
+      delay(10);
+    }
+    if(res == WIFI_SCAN_RUNNING) res = WIFI_SCAN_FAILED;
+  }
+
+  _numNetworks = res > 0 ? res : 0;
+  #ifdef WM_DEBUG_LEVEL
+  if(res == WIFI_SCAN_FAILED) DEBUG_WM(WM_DEBUG_ERROR,F("[ERROR] scan failed"));
+  DEBUG_WM(WM_DEBUG_VERBOSE,F("WiFi Scan targeted completed"), "in "+(String)(millis() - _startscan)+" ms");
+  #endif
+  return _numNetworks > 0;
+}
+
+/**
+ * find ssid in scan results
+ * @since $dev
+ * @param  String ssid
+ * @return int    scan index of strongest match, -1 if not found
+ */
+int WiFiManager::WiFi_scanFind(const String &ssid){
+  int found = -1;
+  for(int i = 0; i < _numNetworks; i++){
+    if(WiFi.SSID(i) != ssid) continue;
+    if(found < 0 || WiFi.RSSI(i) > WiFi.RSSI(found)) found = i;
+  }
+  return found;
+}
+
+/**
+ * scan results include a hidden network, listed without its ssid
+ * @since $dev
+ * @return bool
+ */
+bool WiFiManager::WiFi_scanHasHidden(){
+  for(int i = 0; i < _numNetworks; i++){
+    if(WiFi.SSID(i) == "") return true;
+  }
+  return false;
+}
+
+/**
+ * directed scan for a single ssid, fast check if an ap is in range
+ * @since $dev
+ * @param  String   ssid     ssid to probe for
+ * @param  uint16_t channels channel list WM_SCAN_CHANNEL(n), 0 for all
+ * @return int      scan index of strongest match, -1 if not found
+ */
+int WiFiManager::WiFi_scanForSSID(const String &ssid, uint16_t channels){
+  if(ssid == "") return -1;
+  wm_scan_opts_t opts = _scanOpts;
+  opts.ssid     = ssid.c_str();
+  opts.channels = channels;
+  opts.hidden   = true; // list hidden aps when the core cannot filter by ssid
+  WiFi_scanNetworks(opts);
+  int found = WiFi_scanFind(ssid);
+  #ifdef WM_DEBUG_LEVEL
+  if(found < 0) DEBUG_WM(WM_DEBUG_VERBOSE,F("Directed scan, AP not found:"),ssid);
+  else DEBUG_WM(WM_DEBUG_VERBOSE,F("Directed scan, AP found on channel:"),(String)WiFi.channel(found) + " " + (String)WiFi.RSSI(found) + "dBm");
+  #endif
+  return found;
+}
+
+/**
+ * select scan results to show, bounded top-K by RSSI
+ * applies ssid search, _minimumQuality and duplicate ssid removal, then keeps the _maxNetworks
+ * strongest in a min heap, so memory stays bounded no matter how many aps are in the air
+ * @since $dev
+ * @param std::vector<int> &indices scan indices out, RSSI sorted strongest first
+ * @param String           query    ssid prefix filter, case insensitive
+ */
+void WiFiManager::getScanIndices(std::vector<int> &indices, const String &query){
+  struct scanitem_t {
+    int     idx;
+    int32_t rssi;
+    String  ssid;
+  };
+  // min heap on rssi, weakest kept item on top
+  auto weaker = [](const scanitem_t &a, const scanitem_t &b){ return a.rssi > b.rssi; };
+
+  int n     = _numNetworks;
+  int limit = (_maxNetworks > 0 && _maxNetworks < n) ? _maxNetworks : n;
+  std::vector<scanitem_t> heap;
+  heap.reserve(limit);
+
+  String prefix = query;
+  prefix.toLowerCase();
+
+  for (int i = 0; i < n; i++) {
+    String  ssid = WiFi.SSID(i);
+    int32_t rssi = WiFi.RSSI(i);
+    if(ssid == "") continue; // No idea why I am seeing these, lets just skip them for now
+    if(prefix != ""){
+      String lssid = ssid;
+      lssid.toLowerCase();
+      if(!lssid.startsWith(prefix)) continue;
+    }
+    if(_minimumQuality != -1 && _minimumQuality >= getRSSIasQuality(rssi)){
+      #ifdef WM_DEBUG_LEVEL
+      DEBUG_WM(WM_DEBUG_VERBOSE,F("Skipping , does not meet _minimumQuality"));
+      #endif
+      continue;
+    }
+
+    // remove duplicates, keep strongest
+    if (_removeDuplicateAPs) {
+      bool dup = false;
+      for (auto &item : heap) {
+        if (item.ssid != ssid) continue;
+        dup = true;
+        #ifdef WM_DEBUG_LEVEL
+        DEBUG_WM(WM_DEBUG_VERBOSE,F("DUP AP:"),ssid);
+        #endif
+        if (rssi > item.rssi) {
+          item.idx  = i;
+          item.rssi = rssi;
+          std::make_heap(heap.begin(), heap.end(), weaker);
+        }
+        break;
+      }
+      if (dup) continue;
+    }
+
+    if ((int)heap.size() < limit) {
+      heap.push_back({i, rssi, ssid});
+      std::push_heap(heap.begin(), heap.end(), weaker);
+    }
+    else if (limit > 0 && rssi > heap.front().rssi) {
+      std::pop_heap(heap.begin(), heap.end(), weaker);
+      heap.back() = {i, rssi, ssid};
+      std::push_heap(heap.begin(), heap.end(), weaker);
+    }
+    delay(0);
+  }
+
+  // RSSI SORT, strongest first
+  std::sort_heap(heap.begin(), heap.end(), weaker);
+  indices.clear();
+  indices.reserve(heap.size());
+  for (auto &item : heap) indices.push_back(item.idx);
+}
+
+/**
+ * scan list html
+ * @param  int    page  page number of _scanPageSize items, -1 for all, internal callers only
+ * @param  String query ssid prefix search
+ * @param  int    *next out, next page number, 0 if last page
+ * @return String html
+ */
+String WiFiManager::getScanItemOut(int page_, const String &query, int *next){
     String page;
+    if(next) *next = 0;
 
     if(!_numNetworks) WiFi_scanNetworks(); // scan in case this gets called before any scans
 
@@ -1585,43 +3621,17 @@ String WiFiManager::WiFiManager::getScanItemOut(){
       #ifdef WM_DEBUG_LEVEL
       DEBUG_WM(n,F("networks found"));
       #endif
-      //sort networks
-      int indices[n];
-      for (int i = 0; i < n; i++) {
-        indices[i] = i;
-      }
-
-      // RSSI SORT
-      for (int i = 0; i < n; i++) {
-        for (int j = i + 1; j < n; j++) {
-          if (WiFi.RSSI(indices[j]) > WiFi.RSSI(indices[i])) {
-            std::swap(indices[i], indices[j]);
-          }
-        }
-      }
-
-      /* test std:sort
-        std::sort(indices, indices + n, [](const int & a, const int & b) -> bool
-        {
-        return WiFi.RSSI(a) > WiFi.RSSI(b);
-        });
-       */
-
-      // remove duplicates ( must be RSSI sorted )
-      if (_removeDuplicateAPs) {
-        String cssid;
-        for (int i = 0; i < n; i++) {
-          if (indices[i] == -1) continue;
-          cssid = WiFi.SSID(indices[i]);
-          for (int j = i + 1; j < n; j++) {
-            if (cssid == WiFi.SSID(indices[j])) {
-              #ifdef WM_DEBUG_LEVEL
-              DEBUG_WM(WM_DEBUG_VERBOSE,F("DUP AP:"),WiFi.SSID(indices[j]));
-              #endif
-              indices[j] = -1; // set dup aps to index -1
-            }
-          }
-        }
+      // filter, dedup and sort networks, bounded by _maxNetworks
+      std::vector<int> indices;
+      getScanIndices(indices,query);
+
+      // page slice
+      size_t start = 0;
+      size_t end   = indices.size();
+      if(page_ >= 0 && _scanPageSize > 0){
+        start = std::min(end,(size_t)page_ * _scanPageSize);
+        end   = std::min(end,start + _scanPageSize);
+        if(next && end < indices.size()) *next = page_ + 1;
       }
 
       // token precheck, to speed up replacements on large ap lists
@@ -1641,48 +3651,36 @@ String WiFiManager::WiFiManager::getScanItemOut(){
       bool tok_i = HTTP_ITEM_STR.indexOf(FPSTR(T_i)) > 0;
       
       //display networks in page
-      for (int i = 0; i < n; i++) {
-        if (indices[i] == -1) continue; // skip dups
-
+      for (size_t i = start; i < end; i++) {
+        int idx = indices[i];
         #ifdef WM_DEBUG_LEVEL
-        DEBUG_WM(WM_DEBUG_VERBOSE,F("AP: "),(String)WiFi.RSSI(indices[i]) + " " + (String)WiFi.SSID(indices[i]));
+        DEBUG_WM(WM_DEBUG_VERBOSE,F("AP: "),(String)WiFi.RSSI(idx) + " " + (String)WiFi.SSID(idx));
         #endif
 
-        int rssiperc = getRSSIasQuality(WiFi.RSSI(indices[i]));
-        uint8_t enc_type = WiFi.encryptionType(indices[i]);
-
-        if (_minimumQuality == -1 || _minimumQuality < rssiperc) {
-          String item = HTTP_ITEM_STR;
-          if(WiFi.SSID(indices[i]) == ""){
-            // Serial.println(WiFi.BSSIDstr(indices[i]));
-            continue; // No idea why I am seeing these, lets just skip them for now
-          }
-          item.replace(FPSTR(T_V), htmlEntities(WiFi.SSID(indices[i]))); // ssid no encoding
-          item.replace(FPSTR(T_v), htmlEntities(WiFi.SSID(indices[i]),true)); // ssid no encoding
-          if(tok_e) item.replace(FPSTR(T_e), encryptionTypeStr(enc_type));
-          if(tok_r) item.replace(FPSTR(T_r), (String)rssiperc); // rssi percentage 0-100
-          if(tok_R) item.replace(FPSTR(T_R), (String)WiFi.RSSI(indices[i])); // rssi db
-          if(tok_q) item.replace(FPSTR(T_q), (String)int(round(map(rssiperc,0,100,1,4)))); //quality icon 1-4
-          if(tok_i){
-            if (enc_type != WM_WIFIOPEN) {
-              item.replace(FPSTR(T_i), F("l"));
-            } else {
-              item.replace(FPSTR(T_i), "");
-            }
+        int rssiperc = getRSSIasQuality(WiFi.RSSI(idx));
+        uint8_t enc_type = WiFi.encryptionType(idx);
+
+        String item = HTTP_ITEM_STR;
+        item.replace(FPSTR(T_V), htmlEntities(WiFi.SSID(idx))); // ssid no encoding
+        item.replace(FPSTR(T_v), htmlEntities(WiFi.SSID(idx),true)); // ssid no encoding
+        if(tok_e) item.replace(FPSTR(T_e), encryptionTypeStr(enc_type));
+        if(tok_r) item.replace(FPSTR(T_r), (String)rssiperc); // rssi percentage 0-100
+        if(tok_R) item.replace(FPSTR(T_R), (String)WiFi.RSSI(idx)); // rssi db
+        if(tok_q) item.replace(FPSTR(T_q), (String)int(round(map(rssiperc,0,100,1,4)))); //quality icon 1-4
+        if(tok_i){
+          if (enc_type != WM_WIFIOPEN) {
+            item.replace(FPSTR(T_i), F("l"));
+          } else {
+            item.replace(FPSTR(T_i), "");
           }
-          #ifdef WM_DEBUG_LEVEL
-          DEBUG_WM(WM_DEBUG_DEV,item);
-          #endif
-          page += item;
-          delay(0);
-        } else {
-          #ifdef WM_DEBUG_LEVEL
-          DEBUG_WM(WM_DEBUG_VERBOSE,F("Skipping , does not meet _minimumQuality"));
-          #endif
         }
-
+        #ifdef WM_DEBUG_LEVEL
+        DEBUG_WM(WM_DEBUG_DEV,item);
+        #endif
+        page += item;
+        delay(0);
       }
-      page += FPSTR(HTTP_BR);
+      if(page_ < 0) page += FPSTR(HTTP_BR);
     }
 
     return page;
@@ -1727,7 +3725,12 @@ String WiFiManager::getStaticOut(){
   return page;
 }
 
-String WiFiManager::getParamOut(){
+/**
+ * parameter form items of a section, "" for parameters without a section
+ * @param  String section
+ * @return String html
+ */
+String WiFiManager::getParamOut(const String &section){
   String page;
 
   #ifdef WM_DEBUG_LEVEL
@@ -1750,8 +3753,7 @@ String WiFiManager::getParamOut(){
     char valLength[5];
 
     for (int i = 0; i < _paramsCount; i++) {
-      //Serial.println((String)_params[i]->_length);
-      if (_params[i] == NULL || _params[i]->_length > 99999) {
+      if (!paramValid(_params[i])) {
         // try to detect param scope issues, doesnt always catch but works ok
         #ifdef WM_DEBUG_LEVEL
         DEBUG_WM(WM_DEBUG_ERROR,F("[ERROR] WiFiManagerParameter is out of scope"));
@@ -1762,20 +3764,23 @@ String WiFiManager::getParamOut(){
 
     // add the extra parameters to the form
     for (int i = 0; i < _paramsCount; i++) {
+     if(!paramInSection(_params[i], section)) continue;
      // label before or after, @todo this could be done via floats or CSS and eliminated
      String pitem;
+      // input template, typed parameters may render their own element
+      const char *input = _params[i]->getInputTemplate();
       switch (_params[i]->getLabelPlacement()) {
         case WFM_LABEL_BEFORE:
           pitem = FPSTR(HTTP_FORM_LABEL);
-          pitem += FPSTR(HTTP_FORM_PARAM);
+          pitem += FPSTR(input);
           break;
         case WFM_LABEL_AFTER:
-          pitem = FPSTR(HTTP_FORM_PARAM);
+          pitem = FPSTR(input);
           pitem += FPSTR(HTTP_FORM_LABEL);
           break;
         default:
           // WFM_NO_LABEL
-          pitem = FPSTR(HTTP_FORM_PARAM);
+          pitem = FPSTR(input);
           break;
       }
 
@@ -1787,13 +3792,16 @@ String WiFiManager::getParamOut(){
         if(tok_i)pitem.replace(FPSTR(T_i), _params[i]->getID()); // T_i id name
         if(tok_n)pitem.replace(FPSTR(T_n), _params[i]->getID()); // T_n id name alias
         if(tok_p)pitem.replace(FPSTR(T_p), FPSTR(T_t)); // T_p replace legacy placeholder token
-        if(tok_t)pitem.replace(FPSTR(T_t), _params[i]->getLabel()); // T_t title/label
+        if(tok_t)pitem.replace(FPSTR(T_t), _params[i]->getLabelString()); // T_t title/label
         snprintf(valLength, 5, "%d", _params[i]->getValueLength());
         if(tok_l)pitem.replace(FPSTR(T_l), valLength); // T_l value length
-        if(tok_v)pitem.replace(FPSTR(T_v), _params[i]->getValue()); // T_v value
-        if(tok_c)pitem.replace(FPSTR(T_c), _params[i]->getCustomHTML()); // T_c meant for additional attributes, not html, but can stuff
+        if(tok_v)pitem.replace(FPSTR(T_v), _params[i]->getInputValue()); // T_v value
+        String attr = _params[i]->getInputAttributes(); // typed input attributes, before custom
+        if(attr != "") attr += ' ';
+        if(tok_c)pitem.replace(FPSTR(T_c), attr + _params[i]->getCustomHTMLString()); // T_c meant for additional attributes, not html, but can stuff
+        if(input != HTTP_FORM_PARAM) pitem.replace(FPSTR(T_o), _params[i]->getInputOptions()); // T_o select options
       } else {
-        pitem = _params[i]->getCustomHTML();
+        pitem = _params[i]->getCustomHTMLString();
       }
 
       page += pitem;
@@ -1803,6 +3811,56 @@ String WiFiManager::getParamOut(){
   return page;
 }
 
+/**
+ * links to the parameter section sub-pages, each section once in add order
+ * @since $dev
+ * @return String html, empty when no parameter has a section
+ */
+String WiFiManager::getParamSectionsOut(){
+  String page;
+  for (int i = 0; i < _paramsCount; i++) {
+    const char *section = _params[i]->getSection();
+    if(!section) continue;
+    int j = 0;
+    while(j < i && !(_params[j]->getSection() && strcmp(_params[j]->getSection(), section) == 0)) j++;
+    if(j < i) continue; // listed already
+    String pitem = FPSTR(HTTP_PARAM_SECTION);
+    pitem.replace(FPSTR(T_v), htmlEntities(section));
+    pitem.replace(FPSTR(T_t), htmlEntities(section));
+    page += pitem;
+  }
+  return page;
+}
+
+/**
+ * parameter belongs to section, "" matches parameters without a section
+ * @since $dev
+ */
+bool WiFiManager::paramInSection(const WiFiManagerParameter *p, const String &section){
+  return section == (p->getSection() ? p->getSection() : "");
+}
+
+/**
+ * parameter is set and not destroyed, catches parameters that went out of scope
+ * while their memory is not reused yet
+ * @since $dev
+ */
+bool WiFiManager::paramValid(const WiFiManagerParameter *p){
+  return p != NULL && p->_magic == WM_PARAM_MAGIC;
+}
+
+/**
+ * section is "" or set on a registered parameter
+ * @since $dev
+ */
+bool WiFiManager::paramSectionExists(const String &section){
+  if(section == "") return true;
+  for (int i = 0; i < _paramsCount; i++) {
+    if(_params[i]->getSection() && section == _params[i]->getSection()) return true;
+  }
+  return false;
+}
+
 void WiFiManager::handleWiFiStatus(){
   #ifdef WM_DEBUG_LEVEL
   DEBUG_WM(WM_DEBUG_VERBOSE,F("<- HTTP WiFi status "));
@@ -1837,6 +3895,17 @@ void WiFiManager::handleWifiSave() {
     #endif    
   }
 
+  // strongest bssid and channel of the saved ssid from the portal scan, for the first connect
+  _saveStart = millis();
+  _saveConnectMs = 0;
+  int found = _ssid != "" ? WiFi_scanFind(_ssid) : -1;
+  if(found >= 0){
+    _saveConx.ssidcrc = wm_crc32(_ssid.c_str(),_ssid.length());
+    _saveConx.channel = WiFi.channel(found);
+    memcpy(_saveConx.bssid,WiFi.BSSID(found),sizeof(_saveConx.bssid));
+  }
+  else _saveConx.channel = 0;
+
   #ifdef WM_DEBUG_LEVEL
   String requestinfo = "SERVER_REQUEST\n----------------\n";
   requestinfo += "URI: ";
@@ -1944,44 +4013,241 @@ void WiFiManager::doParamSave(){
     _presaveparamscallback();  // @CALLBACK
   }
 
-  //parameters
-  if(_paramsCount > 0){
+  //parameters, only the submitted section, wifi page and main param page submit none
+  _paramsChanged = 0;
+  String section = server->arg(FPSTR(S_section));
+  if(_paramsCount > 0){
+    #ifdef WM_DEBUG_LEVEL
+    DEBUG_WM(WM_DEBUG_VERBOSE,F("Parameters"));
+    DEBUG_WM(WM_DEBUG_VERBOSE,FPSTR(D_HR));
+    #endif
+
+    // map submitted args to parameters in one pass, param_N wins over the id
+    std::unique_ptr<int16_t[]> argOf(new int16_t[_paramsCount]);
+    for (int i = 0; i < _paramsCount; i++) argOf[i] = -1;
+    size_t prelen = strlen_P(S_parampre);
+    for (int a = 0; a < server->args(); a++) {
+      String name = server->argName(a);
+      int i;
+      if(name.startsWith(FPSTR(S_parampre)) && isDigit(name[prelen])){
+        i = name.substring(prelen).toInt();
+        if(i < 0 || i >= _paramsCount) continue;
+      }
+      else {
+        i = paramIndexFind(name.c_str());
+        if(i < 0 || argOf[i] >= 0) continue;
+      }
+      argOf[i] = a;
+    }
+
+    for (int i = 0; i < _paramsCount; i++) {
+      if (!paramValid(_params[i])) {
+        #ifdef WM_DEBUG_LEVEL
+        DEBUG_WM(WM_DEBUG_ERROR,F("[ERROR] WiFiManagerParameter is out of scope"));
+        #endif
+        break; // @todo might not be needed anymore
+      }
+      if(!_params[i]->getID()) continue; // custom html only
+      _params[i]->_dirty = false;
+      if(!paramInSection(_params[i], section)) continue; // not on the submitted page
+      //read parameter from server, missing is empty (unchecked checkbox)
+      String value;
+      if(argOf[i] >= 0) value = server->arg(argOf[i]);
+
+      //store it in params array, typed parameters parse into native storage
+      paramSet(_params[i], value);
+    }
+    #ifdef WM_DEBUG_LEVEL
+    DEBUG_WM(WM_DEBUG_VERBOSE,F("Parameters changed:"),_paramsChanged);
+    DEBUG_WM(WM_DEBUG_VERBOSE,FPSTR(D_HR));
+    #endif
+  }
+
+  paramsSaved();
+}
+
+/**
+ * set a submitted parameter value, marks it dirty when the value changed
+ * @since $dev
+ * @param  WiFiManagerParameter *p
+ * @param  String               value
+ * @return bool false if rejected, value kept
+ */
+bool WiFiManager::paramSet(WiFiManagerParameter *p, const String &value){
+  uint32_t crc = paramCrc(p);
+  if(!p->setValueFromArg(value)){
+    #ifdef WM_DEBUG_LEVEL
+    DEBUG_WM(WM_DEBUG_ERROR,F("[ERROR] invalid parameter value, kept"),(String)p->getID() + ": " + value);
+    #endif
+    return false;
+  }
+  if(paramCrc(p) != crc){
+    p->_dirty = true;
+    _paramsChanged++;
+  }
+  #ifdef WM_DEBUG_LEVEL
+  DEBUG_WM(WM_DEBUG_VERBOSE,(String)p->getID() + (p->_dirty ? "* :" : ":"),value);
+  #endif
+  return true;
+}
+
+/**
+ * after parameters are set, store changed records and fire change and save callbacks
+ * @since $dev
+ */
+void WiFiManager::paramsSaved(){
+  if(_paramStore && _paramsChanged) saveParameters(); // changed records only
+
+  // after all values are set, so callbacks see a consistent set
+  for (int i = 0; i < _paramsCount && _paramsChanged; i++) {
+    if(!_params[i]->_dirty) continue;
+    if(_params[i]->_changedcallback != NULL) _params[i]->_changedcallback(_params[i]);  // @CALLBACK
+    if(_paramchangedcallback != NULL) _paramchangedcallback(_params[i]);  // @CALLBACK
+  }
+
+   if ( _saveparamscallback != NULL && (!_saveParamsOnChange || _paramsChanged)) {
+    _saveparamscallback();  // @CALLBACK
+  }
+}
+
+/**
+ * HTTPD CALLBACK /api/config, bulk provisioning
+ * GET returns {"params":{"id":"value",..},"wifi":{"ssid":".."},"ip":{"ip":"..","gw":"..","sn":"..","dns":".."}}, no password
+ * POST takes the same object, any subset, plus "wifi":{"pass":".."}
+ * every value is validated before anything is applied, one rejected value rejects the whole body (400, "error" key)
+ * wifi.ssid without wifi.pass keeps the saved password for the saved ssid, other ssids need a pass, "" for open
+ * then parameters are set as on a param save with one save params callback, wifi credentials connect like a wifi save
+ */
+void WiFiManager::handleConfigApi(){
+  #ifdef WM_DEBUG_LEVEL
+  DEBUG_WM(WM_DEBUG_VERBOSE,F("<- HTTP Config API"));
+  #endif
+  handleRequest();
+  if(server->method() == HTTP_GET){
+    server->send(200, FPSTR(HTTP_HEAD_CTJSON), getConfigJson());
+    return;
+  }
+
+  // validate pass
+  std::vector<std::pair<WiFiManagerParameter*,String>> params;
+  String ssid, pass, error;
+  bool wifi = false, passSet = false;
+  IPAddress ips[4];
+  uint8_t ipset = 0;
+  const char *ipkeys[] = {"ip.ip", "ip.gw", "ip.sn", "ip.dns"};
+
+  std::function<bool(const String&, const String&)> leaf = [&](const String &key, const String &value) -> bool {
+    if(key.startsWith(F("params."))){
+      WiFiManagerParameter *p = getParameter(key.c_str() + 7);
+      if(!p || (!p->_value && !p->getStoreSize())) return false; // no value storage, setValueFromArg would fail
+      if(!p->validate(value)) return false;
+      params.push_back(std::make_pair(p, value));
+      return true;
+    }
+    if(key == F("wifi.ssid")){
+      ssid = value;
+      wifi = true;
+      return value.length() <= 32;
+    }
+    if(key == F("wifi.pass")){
+      pass    = value;
+      passSet = true;
+      return value.length() <= 64; // same as the wifi form, wep keys are 5 or 13
+    }
+    for(uint8_t i=0; i<4; i++){
+      if(key != ipkeys[i]) continue;
+      ipset |= 1 << i;
+      return value == "" || optionalIPFromString(&ips[i], value.c_str());
+    }
+    return false; // unknown key
+  };
+  std::function<bool(const String&, const String&)> check = [&](const String &key, const String &value) -> bool {
+    if(leaf(key, value)) return true;
+    error = key;
+    return false;
+  };
+
+  String body = server->arg(F("plain"));
+  const char *p = body.c_str();
+  bool ok = wm_json_object(p, "", check);
+  wm_json_ws(p);
+  if(ok && !*p && wifi && ssid != "" && !passSet){
+    if(ssid == WiFi_SSID(true)) pass = WiFi_psk(true); // keep the saved password
+    else {
+      ok    = false;
+      error = F("wifi.pass");
+    }
+  }
+  if(!ok || *p){
+    if(error == "") error = F("json");
     #ifdef WM_DEBUG_LEVEL
-    DEBUG_WM(WM_DEBUG_VERBOSE,F("Parameters"));
-    DEBUG_WM(WM_DEBUG_VERBOSE,FPSTR(D_HR));
+    DEBUG_WM(WM_DEBUG_ERROR,F("[ERROR] config rejected:"),error);
     #endif
+    server->send(400, FPSTR(HTTP_HEAD_CTJSON), (String)F("{\"result\":false,\"error\":\"") + wm_json_escape(error) + F("\"}"));
+    return;
+  }
 
-    for (int i = 0; i < _paramsCount; i++) {
-      if (_params[i] == NULL || _params[i]->_length > 99999) {
-        #ifdef WM_DEBUG_LEVEL
-        DEBUG_WM(WM_DEBUG_ERROR,F("[ERROR] WiFiManagerParameter is out of scope"));
-        #endif
-        break; // @todo might not be needed anymore
-      }
-      //read parameter from server
-      String name = (String)FPSTR(S_parampre)+(String)i;
-      String value;
-      if(server->hasArg(name)) {
-        value = server->arg(name);
-      } else {
-        value = server->arg(_params[i]->getID());
-      }
-
-      //store it in params array
-      value.toCharArray(_params[i]->_value, _params[i]->_length+1); // length+1 null terminated
+  // apply pass, every value was checked against the same rules setValueFromArg applies
+  if(wifi && _presavewificallback != NULL) _presavewificallback();  // @CALLBACK
+  if(_presaveparamscallback != NULL) _presaveparamscallback();  // @CALLBACK
+  _paramsChanged = 0;
+  for (int i = 0; i < _paramsCount; i++) _params[i]->_dirty = false;
+  for (auto &param : params){
+    if(!paramSet(param.first, param.second)){
       #ifdef WM_DEBUG_LEVEL
-      DEBUG_WM(WM_DEBUG_VERBOSE,(String)_params[i]->getID() + ":",value);
+      DEBUG_WM(WM_DEBUG_ERROR,F("[ERROR] config apply failed after validation:"),param.first->getID());
       #endif
     }
-    #ifdef WM_DEBUG_LEVEL
-    DEBUG_WM(WM_DEBUG_VERBOSE,FPSTR(D_HR));
-    #endif
+  }
+  paramsSaved();
+
+  if(ipset & 1) _sta_static_ip  = ips[0];
+  if(ipset & 2) _sta_static_gw  = ips[1];
+  if(ipset & 4) _sta_static_sn  = ips[2];
+  if(ipset & 8) _sta_static_dns = ips[3];
+
+  if(wifi && ssid != ""){
+    _ssid = ssid;
+    _pass = pass;
+    _saveStart = millis();
+    _saveConnectMs = 0;
+    _saveConx.channel = 0; // no scan lookup, regular connect
+    connect = true; // connect in processConfigPortal, as a wifi save
   }
 
-   if ( _saveparamscallback != NULL) {
-    _saveparamscallback();  // @CALLBACK
+  server->send(200, FPSTR(HTTP_HEAD_CTJSON), (String)F("{\"result\":true,\"changed\":") + _paramsChanged + '}');
+}
+
+/**
+ * /api/config export, parameter values as strings, saved ssid, static ip if set
+ * @since $dev
+ * @return String json
+ */
+String WiFiManager::getConfigJson(){
+  String out = F("{\"params\":{");
+  bool first = true;
+  for (WiFiManagerParameter *p : parameters()) {
+    if(!p->getID()) continue;
+    if(!first) out += ',';
+    first = false;
+    out += '"';
+    out += p->getID();
+    out += F("\":\"");
+    out += wm_json_escape(p->getValueString());
+    out += '"';
+  }
+  out += F("},\"wifi\":{\"ssid\":\"");
+  out += wm_json_escape(WiFi_SSID(true));
+  out += F("\"}");
+  if(_sta_static_ip){
+    out += F(",\"ip\":{\"ip\":\"");    out += _sta_static_ip.toString();
+    out += F("\",\"gw\":\"");           out += _sta_static_gw.toString();
+    out += F("\",\"sn\":\"");           out += _sta_static_sn.toString();
+    out += F("\",\"dns\":\"");          out += _sta_static_dns.toString();
+    out += F("\"}");
   }
-   
+  out += '}';
+  return out;
 }
 
 /** 
@@ -2000,7 +4266,7 @@ void WiFiManager::handleInfo() {
   //@todo convert to enum or refactor to strings
   //@todo wrap in build flag to remove all info code for memory saving
   #ifdef ESP8266
-    infos = 28;
+    infos = 29;
     String infoids[] = {
       F("esphead"),
       F("uptime"),
@@ -2017,6 +4283,7 @@ void WiFiManager::handleInfo() {
       F("lastreset"),
       F("wifihead"),
       F("conx"),
+      F("conxtime"),
       F("stassid"),
       F("staip"),
       F("stagw"),
@@ -2034,7 +4301,7 @@ void WiFiManager::handleInfo() {
 
   #elif defined(ESP32)
     // add esp_chip_info ?
-    infos = 27;
+    infos = 28;
     String infoids[] = {
       F("esphead"),
       F("uptime"),
@@ -2051,6 +4318,7 @@ void WiFiManager::handleInfo() {
       // F("hall"),
       F("wifihead"),
       F("conx"),
+      F("conxtime"),
       F("stassid"),
       F("staip"),
       F("stagw"),
@@ -2279,6 +4547,14 @@ String WiFiManager::getInfoData(String id){
     p = FPSTR(HTTP_INFO_conx);
     p.replace(FPSTR(T_1),WiFi.isConnected() ? FPSTR(S_y) : FPSTR(S_n));
   }
+  else if(id==F("conxtime")){
+    wm_conx_timeline_t tl;
+    if(getConnectTimeline(tl)){
+      p = FPSTR(HTTP_INFO_conxtime);
+      p.replace(FPSTR(T_1),(String)(tl.end - tl.start) + " ms, assoc " + (String)(tl.assoc ? tl.assoc - tl.start : 0) +
+        " ms, ip " + (String)(tl.gotip ? tl.gotip - tl.start : 0) + " ms, " + getWLStatusString(tl.result));
+    }
+  }
   #ifdef ESP8266
   else if(id==F("autoconx")){
     p = FPSTR(HTTP_INFO_autoconx);
@@ -2655,7 +4931,11 @@ void WiFiManager::resetSettings() {
   DEBUG_WM(F("resetSettings"));
   #endif
   WiFi_enableSTA(true,true); // must be sta to disconnect erase
+  #ifdef ESP32
+  waitFor([](){ return (WiFi.getStatusBits() & STA_STARTED_BIT) != 0; },500,WM_WAIT_RESET); // sta start event
+  #else
   delay(500); // ensure sta is enabled
+  #endif
   if (_resetcallback != NULL){
       _resetcallback();  // @CALLBACK
   }
@@ -2667,6 +4947,9 @@ void WiFiManager::resetSettings() {
     WiFi.disconnect(true);
     WiFi.persistent(false);
   #endif
+  fastConnectClear();
+  dhcpCacheClear();
+  credClear();
   #ifdef WM_DEBUG_LEVEL
   DEBUG_WM(F("SETTINGS ERASED"));
   #endif
@@ -2875,6 +5158,39 @@ void WiFiManager::setSaveParamsCallback( std::function<void()> func ) {
   _saveparamscallback = func;
 }
 
+/**
+ * setConfigApi, enable the /api/config json endpoint for bulk provisioning
+ * GET exports parameters, ssid and static ip, POST validates and applies them all or nothing
+ * the portal has no authentication, credentials can be written by any client
+ * @since $dev
+ * @access public
+ * @param boolean enabled [false]
+ */
+void WiFiManager::setConfigApi(boolean enabled) {
+  _configApi = enabled;
+}
+
+/**
+ * setParamChangedCallback, called for each parameter whose value changed on params save
+ * filter on param->getID(), or use WiFiManagerParameter::setChangedCallback for a single parameter
+ * @since $dev
+ * @access public
+ * @param std::function<void(WiFiManagerParameter*)> func
+ */
+void WiFiManager::setParamChangedCallback( std::function<void(WiFiManagerParameter*)> func ) {
+  _paramchangedcallback = func;
+}
+
+/**
+ * setSaveParamsOnChange, only call the save params callback when a parameter value changed
+ * @since $dev
+ * @access public
+ * @param boolean enabled [false]
+ */
+void WiFiManager::setSaveParamsOnChange(boolean enabled) {
+  _saveParamsOnChange = enabled;
+}
+
 /**
  * setPreSaveParamsCallback, set a pre save params callback on params save prior to anything else
  * @access public
@@ -2902,6 +5218,16 @@ void WiFiManager::setConfigPortalTimeoutCallback( std::function<void()> func ) {
   _configportaltimeoutcallback = func;
 }
 
+/**
+ * setAsyncConnectCallback, set a callback for autoConnectAsync state changes
+ * @since $dev
+ * @access public
+ * @param {[type]} void (*func)(wm_async_state_t state)
+ */
+void WiFiManager::setAsyncConnectCallback( std::function<void(wm_async_state_t)> func ) {
+  _asyncconnectcallback = func;
+}
+
 /**
  * set custom head html
  * custom element will be added to head, eg. new meta,style,script tag etc.
@@ -2909,7 +5235,19 @@ void WiFiManager::setConfigPortalTimeoutCallback( std::function<void()> func ) {
  * @param char element
  */
 void WiFiManager::setCustomHeadElement(const char* html) {
-  _customHeadElement = html;
+  _customHeadElement  = html;
+  _customHeadElementP = false;
+}
+
+/**
+ * set custom head html from flash, F("..") or FPSTR(), read from flash on each page
+ * @since $dev
+ * @access public
+ * @param __FlashStringHelper element
+ */
+void WiFiManager::setCustomHeadElement(const __FlashStringHelper* html) {
+  _customHeadElement  = (const char*)html;
+  _customHeadElementP = true;
 }
 
 /**
@@ -2919,7 +5257,19 @@ void WiFiManager::setCustomHeadElement(const char* html) {
  * @param char element
  */
 void WiFiManager::setCustomBodyHeader(const char* html) {
-    _customBodyHeader = html;
+    _customBodyHeader  = html;
+    _customBodyHeaderP = false;
+}
+
+/**
+ * set custom html at the top of the body, from flash
+ * @since $dev
+ * @access public
+ * @param __FlashStringHelper element
+ */
+void WiFiManager::setCustomBodyHeader(const __FlashStringHelper* html) {
+    _customBodyHeader  = (const char*)html;
+    _customBodyHeaderP = true;
 }
 
 /**
@@ -2929,7 +5279,19 @@ void WiFiManager::setCustomBodyHeader(const char* html) {
  * @param char element
  */
 void WiFiManager::setCustomBodyFooter(const char* html) {
-    _customBodyFooter = html;
+    _customBodyFooter  = html;
+    _customBodyFooterP = false;
+}
+
+/**
+ * set custom html at the bottom of the body, from flash
+ * @since $dev
+ * @access public
+ * @param __FlashStringHelper element
+ */
+void WiFiManager::setCustomBodyFooter(const __FlashStringHelper* html) {
+    _customBodyFooter  = (const char*)html;
+    _customBodyFooterP = true;
 }
 
 /**
@@ -2939,7 +5301,19 @@ void WiFiManager::setCustomBodyFooter(const char* html) {
  * @param char element
  */
 void WiFiManager::setCustomMenuHTML(const char* html) {
-  _customMenuHTML = html;
+  _customMenuHTML  = html;
+  _customMenuHTMLP = false;
+}
+
+/**
+ * set custom menu html, from flash
+ * @since $dev
+ * @access public
+ * @param __FlashStringHelper element
+ */
+void WiFiManager::setCustomMenuHTML(const __FlashStringHelper* html) {
+  _customMenuHTML  = (const char*)html;
+  _customMenuHTMLP = true;
 }
 
 /**
@@ -2952,6 +5326,29 @@ void WiFiManager::setRemoveDuplicateAPs(boolean removeDuplicates) {
   _removeDuplicateAPs = removeDuplicates;
 }
 
+/**
+ * paginate wifi scan list
+ * wifi page renders the first page with an ssid search and more button, remaining pages
+ * are fetched on demand from /wifiscan, keeps responses small on weak softap links
+ * @since $dev
+ * @access public
+ * @param uint8_t size networks per page, 0 for one page
+ */
+void WiFiManager::setScanPageSize(uint8_t size){
+  _scanPageSize = size;
+}
+
+/**
+ * set max number of networks shown in wifi scan
+ * strongest networks are kept, bounds page size and memory in dense rf environments
+ * @since $dev
+ * @access public
+ * @param uint8_t max networks, 0 for no limit
+ */
+void WiFiManager::setMaxScanNetworks(uint8_t max){
+  _maxNetworks = max;
+}
+
 /**
  * toggle configportal blocking loop
  * if enabled, then the configportal will enter a blocking loop and wait for configuration
@@ -2961,6 +5358,10 @@ void WiFiManager::setRemoveDuplicateAPs(boolean removeDuplicates) {
  * @param boolean shoudlBlock [false]
  */
 void WiFiManager::setConfigPortalBlocking(boolean shouldBlock) {
+  if(_configPortalBlockingRestore){
+    _configPortalBlockingUser = shouldBlock; // applies when the internal non blocking portal closes
+    return;
+  }
   _configPortalIsBlocking = shouldBlock;
 }
 
@@ -3041,6 +5442,43 @@ void WiFiManager::setWiFiAutoReconnect(boolean enabled){
   _wifiAutoReconnect = enabled;
 }
 
+/**
+ * set managed reconnect policy
+ * if enabled, the sdk autoreconnect is turned off and process() reconnects with exponential backoff,
+ * each interval spread by random jitter so devices losing the same ap do not reconnect in lockstep
+ * requires process() to be called from loop
+ * @since $dev
+ * @access public
+ * @param boolean       enabled
+ * @param unsigned long base   seconds first interval [1]
+ * @param unsigned long max    seconds max interval [300]
+ * @param uint8_t       jitter percent spread of each interval [25]
+ * @param unsigned long outage seconds offline before the config portal is started, 0 never [0]
+ */
+void WiFiManager::setReconnectPolicy(boolean enabled, unsigned long base, unsigned long max, uint8_t jitter, unsigned long outage){
+  _reconnPolicy   = enabled;
+  _reconnBase     = std::max(base,1UL) * 1000;
+  _reconnMax      = std::max(max * 1000,_reconnBase);
+  _reconnJitter   = std::min(jitter,(uint8_t)100);
+  _reconnOutage   = outage * 1000;
+  WiFi_autoReconnect();
+}
+
+/**
+ * get reconnect policy counters
+ * @since $dev
+ * @access public
+ * @return wm_reconnect_stats_t
+ */
+wm_reconnect_stats_t WiFiManager::getReconnectStats(){
+  wm_reconnect_stats_t stats = _reconnStats;
+  if(_reconnDown){
+    stats.outageMs   = millis() - _reconnDown;
+    stats.offlineMs += stats.outageMs;
+  }
+  return stats;
+}
+
 /**
  * toggle configportal timeout wait for station client
  * if enabled, then the configportal will start timeout when no stations are connected to softAP
@@ -3241,71 +5679,307 @@ void WiFiManager::setMenu(std::vector<const char *>& menu){
 
 
 /**
- * set params as sperate page not in wifi
- * NOT COMPATIBLE WITH setMenu! 
- * @todo scan menuids and insert param after wifi or something, same for ota
- * @param bool enable 
+ * set params as sperate page not in wifi
+ * NOT COMPATIBLE WITH setMenu! 
+ * @todo scan menuids and insert param after wifi or something, same for ota
+ * @param bool enable 
+ * @since $dev
+ */
+void WiFiManager::setParamsPage(bool enable){
+  _paramsInWifi  = !enable;
+  setMenu(enable ? _menuIdsParams : _menuIdsDefault);
+}
+
+// GETTERS
+
+/**
+ * get config portal AP SSID
+ * @since 0.0.1
+ * @access public
+ * @return String the configportal ap name
+ */
+String WiFiManager::getConfigPortalSSID() {
+  return _apName;
+}
+
+/**
+ * return the last known connection result
+ * logged on autoconnect and wifisave, can be used to check why failed
+ * get as readable string with getWLStatusString(getLastConxResult);
+ * @since $dev
+ * @access public
+ * @return bool return wl_status codes
+ */
+uint8_t WiFiManager::getLastConxResult(){
+  return _lastconxresult;
+}
+
+/**
+ * check if wifi has a saved ap or not
+ * @since $dev
+ * @access public
+ * @return bool true if a saved ap config exists
+ */
+bool WiFiManager::getWiFiIsSaved(){
+  return WiFi_hasAutoConnect();
+}
+
+/**
+ * getDefaultAPName
+ * @since $dev
+ * @return string 
+ */
+String WiFiManager::getDefaultAPName(){
+  String hostString = String(WIFI_getChipId(),HEX);
+  hostString.toUpperCase();
+  // char hostString[16] = {0};
+  // sprintf(hostString, "%06X", ESP.getChipId());  
+  return _wifissidprefix + "_" + hostString;
+}
+
+/**
+ * setCountry
+ * @since $dev
+ * @param String cc country code, must be defined in WiFiSetCountry, US, JP, CN
+ */
+void WiFiManager::setCountry(String cc){
+  _wificountry = cc;
+}
+
+/**
+ * set scan options for portal and targeted scans
+ * passive, dwell and hidden apply to all scans,
+ * channels and ssid only apply to targeted scans, portal scans always list everything
+ * @since $dev
+ * @access public
+ * @param wm_scan_opts_t opts
+ */
+void WiFiManager::setScanOptions(wm_scan_opts_t opts){
+  _scanOpts = opts;
+}
+
+/**
+ * enable background scan scheduler
+ * async scans run while portal clients are active and back off when idle,
+ * so wifi handlers use fresh cached results without waiting
+ * @since $dev
+ * @access public
+ * @param bool          enable
+ * @param unsigned long interval    seconds between scans while clients are active
+ * @param unsigned long maxinterval seconds max backoff interval when idle
+ */
+void WiFiManager::setBackgroundScan(bool enable, unsigned long interval, unsigned long maxinterval){
+  _bgscan            = enable;
+  _bgscanInterval    = interval * 1000;
+  _bgscanMaxInterval = std::max(interval,maxinterval) * 1000;
+  _bgscanBackoff     = 0;
+  _bgscanNext        = 0;
+}
+
+/**
+ * get scan age
+ * @since $dev
+ * @access public
+ * @return unsigned long ms since last completed scan, 0 if never scanned
+ */
+unsigned long WiFiManager::getScanAge(){
+  return _lastscan ? millis() - _lastscan : 0;
+}
+
+/**
+ * get scan duration
+ * @since $dev
+ * @access public
+ * @return unsigned long ms duration of last completed scan
+ */
+unsigned long WiFiManager::getScanDuration(){
+  return _scanDuration;
+}
+
+/**
+ * fast reconnect
+ * caches the bssid and channel of the last good connection in rtc memory (and flash with WM_FLASHSTORE),
+ * the next connect goes straight to that ap and skips the scan, on failure the cache is dropped and a normal connect is done
+ * @since $dev
+ * @access public
+ * @param bool          enable
+ * @param unsigned long timeout seconds for the fast attempt before falling back
+ */
+void WiFiManager::setFastConnect(bool enable, unsigned long timeout){
+  _fastConnect        = enable;
+  _fastConnectTimeout = timeout * 1000;
+}
+
+/**
+ * scan gate
+ * autoConnect checks the saved network is in range, cached portal scan or a directed scan,
+ * and goes straight to the config portal when it is not instead of waiting out connect timeouts.
+ * with the credential store, networks not in range are skipped including the last good one
+ * @since $dev
+ * @access public
+ * @param bool enable
+ */
+void WiFiManager::setConnectScanGate(bool enable){
+  _scanGate = enable;
+}
+
+/**
+ * fast boot
+ * for wake, connect, sleep duty cycles. a fingerprint of the wifi setup config (hostname, country, reconnect)
+ * is kept in rtc memory after a successful autoConnect, while it matches, autoConnect skips the esp32 wifi off
+ * toggle, enableSTA, country and hostname setters whose target state is already applied, going straight to begin
+ * @since $dev
+ * @access public
+ * @param bool enable
+ */
+void WiFiManager::setFastBoot(bool enable){
+  _fastBoot = enable;
+}
+
+/**
+ * dhcp ip config cache
+ * records the dhcp assigned ip, gateway, netmask and dns after a connect (rtc, and flash with WM_FLASHSTORE)
+ * and reuses them as static config on the next connect to the same ssid, skipping dhcp.
+ * revalidated after connect, if the ap changed the cache is dropped and dhcp runs on the live connection.
+ * not used when a static ip is set via setSTAStaticIPConfig
+ * @since $dev
+ * @access public
+ * @param bool     enable
+ * @param uint16_t maxuses connects on a cached config before a full dhcp refresh, lease renewal
+ */
+void WiFiManager::setDHCPCache(bool enable, uint16_t maxuses){
+  _dhcpCache        = enable;
+  _dhcpCacheMaxUses = maxuses;
+}
+
+/**
+ * get ip cache stats
+ * @since $dev
+ * @access public
+ * @return wm_ipcache_stats_t
+ */
+wm_ipcache_stats_t WiFiManager::getDHCPCacheStats(){
+  return _ipcStats;
+}
+
+/**
+ * credential store
+ * keeps up to WM_MAX_CREDENTIALS networks in flash, crc checked, portal saves are added.
+ * esp32 uses nvs, esp8266 LittleFS (must be LittleFS formatted, never formatted here), else the store is ram only
+ * autoConnect does one scan and tries stored networks by visibility, rssi and last success,
+ * each with its own connect timeout instead of the global connect timeout
+ * @since $dev
+ * @access public
+ * @param bool          enable
+ * @param unsigned long timeout seconds per network
+ * @return bool         false if the store does not persist
+ */
+bool WiFiManager::setCredentialStore(bool enable, unsigned long timeout){
+  _credStore   = enable;
+  _credTimeout = timeout * 1000;
+  #if defined(WM_FLASHSTORE) || defined(WM_CREDSTORE_FLASH)
+  return !enable || storeBegin(); // no flash filesystem, ram only
+  #else
+  #ifdef WM_DEBUG_LEVEL
+  if(enable) DEBUG_WM(WM_DEBUG_ERROR,F("[ERROR] credential store is ram only, esp8266 core has no LittleFS"));
+  #endif
+  return !enable;
+  #endif
+}
+
+/**
+ * add or update a network in the credential store
+ * @since $dev
+ * @access public
+ * @param  const char* ssid
+ * @param  const char* pass
+ * @return bool success
+ */
+bool WiFiManager::addCredential(const char* ssid, const char* pass){
+  return credAdd(ssid,pass,false);
+}
+
+/**
+ * remove a network from the credential store
  * @since $dev
+ * @access public
+ * @param  const char* ssid
+ * @return bool found
  */
-void WiFiManager::setParamsPage(bool enable){
-  _paramsInWifi  = !enable;
-  setMenu(enable ? _menuIdsParams : _menuIdsDefault);
+bool WiFiManager::removeCredential(const char* ssid){
+  int i = credFind(ssid);
+  if(i < 0) return false;
+  _creds->count--;
+  memmove(&_creds->entries[i],&_creds->entries[i+1],(_creds->count - i) * sizeof(wm_credential_t));
+  memset(&_creds->entries[_creds->count],0,sizeof(wm_credential_t));
+  credSave();
+  return true;
 }
 
-// GETTERS
+/**
+ * get credential store count
+ * @since $dev
+ * @access public
+ * @return uint8_t networks stored
+ */
+uint8_t WiFiManager::getCredentialCount(){
+  return credLoad() ? _creds->count : 0;
+}
 
 /**
- * get config portal AP SSID
- * @since 0.0.1
+ * get portal ready time, from the start call to the first request served
+ * @since $dev
  * @access public
- * @return String the configportal ap name
+ * @return unsigned long ms, 0 if no request served yet
  */
-String WiFiManager::getConfigPortalSSID() {
-  return _apName;
+unsigned long WiFiManager::getPortalReadyTime(){
+  return _portalReadyMs;
 }
 
 /**
- * return the last known connection result
- * logged on autoconnect and wifisave, can be used to check why failed
- * get as readable string with getWLStatusString(getLastConxResult);
+ * get portal save to connected time, includes the captive portal close delay
  * @since $dev
  * @access public
- * @return bool return wl_status codes
+ * @return unsigned long ms, 0 if the last save did not connect
  */
-uint8_t WiFiManager::getLastConxResult(){
-  return _lastconxresult;
+unsigned long WiFiManager::getSaveConnectTime(){
+  return _saveConnectMs;
 }
 
 /**
- * check if wifi has a saved ap or not
+ * get readiness wait stats
  * @since $dev
  * @access public
- * @return bool true if a saved ap config exists
+ * @param  wm_wait_id_t id
+ * @return wm_wait_stats_t last, max, count and timeouts
  */
-bool WiFiManager::getWiFiIsSaved(){
-  return WiFi_hasAutoConnect();
+wm_wait_stats_t WiFiManager::getWaitStats(wm_wait_id_t id){
+  return id < WM_WAIT_MAX ? _waitStats[id] : wm_wait_stats_t();
 }
 
 /**
- * getDefaultAPName
+ * get connect attempt timeline
+ * mode, begin, assoc (auth), gotip (dhcp) and end timestamps per attempt, see /conxlog
  * @since $dev
- * @return string 
+ * @access public
+ * @param  wm_conx_timeline_t &timeline out
+ * @param  uint8_t            n        0 for newest
+ * @return bool               false if n is not recorded
  */
-String WiFiManager::getDefaultAPName(){
-  String hostString = String(WIFI_getChipId(),HEX);
-  hostString.toUpperCase();
-  // char hostString[16] = {0};
-  // sprintf(hostString, "%06X", ESP.getChipId());  
-  return _wifissidprefix + "_" + hostString;
+bool WiFiManager::getConnectTimeline(wm_conx_timeline_t &timeline, uint8_t n){
+  if(n >= _conxTimelineCount) return false;
+  timeline = _conxTimeline[(_conxTimelineIdx + WM_CONX_HISTORY - 1 - n) % WM_CONX_HISTORY];
+  return true;
 }
 
 /**
- * setCountry
+ * get connect timeline count
  * @since $dev
- * @param String cc country code, must be defined in WiFiSetCountry, US, JP, CN
+ * @access public
+ * @return uint8_t entries, up to WM_CONX_HISTORY
  */
-void WiFiManager::setCountry(String cc){
-  _wificountry = cc;
+uint8_t WiFiManager::getConnectTimelineCount(){
+  return _conxTimelineCount;
 }
 
 /**
@@ -3657,6 +6331,22 @@ bool WiFiManager::WiFiSetCountry(){
   return ret;
 }
 
+/**
+ * wifi country already set to _wificountry
+ * @since $dev
+ * @return bool applied, false if unknown
+ */
+bool WiFiManager::WiFi_countryApplied(){
+  if(_wificountry == "") return true; // nothing to set
+  wifi_country_t country;
+  #ifdef ESP32
+  if(WiFi.getMode() == WIFI_MODE_NULL || esp_wifi_get_country(&country) != ESP_OK) return false;
+  #elif defined(ESP8266)
+  if(!wifi_get_country(&country)) return false;
+  #endif
+  return strncmp(country.cc,_wificountry.c_str(),2) == 0;
+}
+
 // set mode ignores WiFi.persistent 
 bool WiFiManager::WiFi_Mode(WiFiMode_t m,bool persistent) {
     bool ret;
@@ -3767,7 +6457,7 @@ bool WiFiManager::WiFi_eraseConfig() {
       WiFi.mode(WIFI_AP_STA); // cannot erase if not in STA mode !
       WiFi.persistent(true);
       ret = WiFi.disconnect(true,true); // disconnect(bool wifioff, bool eraseap)
-      delay(500);
+      waitFor([](){ return (WiFi.getStatusBits() & STA_STARTED_BIT) == 0; },500,WM_WAIT_ERASE); // sta stop event, erase done
       WiFi.persistent(false);
       return ret;
     #endif
@@ -3849,7 +6539,34 @@ String WiFiManager::WiFi_psk(bool persistent) const {
     #define wifi_sta_disconnected disconnected
     #define ARDUINO_EVENT_WIFI_STA_DISCONNECTED SYSTEM_EVENT_STA_DISCONNECTED
     #define ARDUINO_EVENT_WIFI_SCAN_DONE SYSTEM_EVENT_SCAN_DONE
+    #define ARDUINO_EVENT_WIFI_STA_CONNECTED SYSTEM_EVENT_STA_CONNECTED
+    #define ARDUINO_EVENT_WIFI_STA_GOT_IP SYSTEM_EVENT_STA_GOT_IP
   #endif
+    // connect timeline
+    wm_conx_timeline_t *tl = _conxCur;
+    if(tl){
+      if(event == ARDUINO_EVENT_WIFI_STA_CONNECTED) tl->assoc = millis();
+      else if(event == ARDUINO_EVENT_WIFI_STA_GOT_IP) tl->gotip = millis();
+      else if(event == ARDUINO_EVENT_WIFI_STA_DISCONNECTED) tl->reason = info.wifi_sta_disconnected.reason;
+    }
+    // dhcp restart zeroes the ip, got ip is the lease, copied only, compared in dhcpCacheProcess
+    if(event == ARDUINO_EVENT_WIFI_STA_GOT_IP && _ipcConfirm){
+      _ipcLeaseIp = info.got_ip.ip_info.ip.addr;
+      _ipcLeaseGw = info.got_ip.ip_info.gw.addr;
+      _ipcLeaseSn = info.got_ip.ip_info.netmask.addr;
+      _ipcLease   = true;
+    }
+
+    // terminal connect failures, connect waits return immediately instead of timing out
+    if(event == ARDUINO_EVENT_WIFI_STA_DISCONNECTED){
+      uint8_t reason = info.wifi_sta_disconnected.reason;
+      if(reason == WIFI_REASON_AUTH_FAIL || reason == WIFI_REASON_AUTH_EXPIRE || reason == WIFI_REASON_4WAY_HANDSHAKE_TIMEOUT || reason == WIFI_REASON_HANDSHAKE_TIMEOUT){
+        _conxFail = WL_CONNECT_FAILED;
+      }
+      else if(reason == WIFI_REASON_NO_AP_FOUND) _conxFail = WL_NO_SSID_AVAIL;
+    }
+    if(_conxEvent) xSemaphoreGive(_conxEvent); // wake connect waits on any event
+
     if(!_hasBegun){
       #ifdef WM_DEBUG_LEVEL
         // DEBUG_WM(WM_DEBUG_VERBOSE,"[ERROR] WiFiEvent, not ready");
@@ -3883,25 +6600,418 @@ String WiFiManager::WiFi_psk(bool persistent) const {
         WiFi.reconnect();
       #endif
   }
-  else if(event == ARDUINO_EVENT_WIFI_SCAN_DONE && _asyncScan){
-    uint16_t scans = WiFi.scanComplete();
-    WiFi_scanComplete(scans);
-  }
 }
 #endif
 
 void WiFiManager::WiFi_autoReconnect(){
   #ifdef ESP8266
-    WiFi.setAutoReconnect(_wifiAutoReconnect);
+    bool enable = _wifiAutoReconnect && !_reconnPolicy;
+    if(WiFi.getAutoReconnect() != enable) WiFi.setAutoReconnect(enable);
   #elif defined(ESP32)
+    WiFi.setAutoReconnect(_wifiAutoReconnect && !_reconnPolicy); // off for managed reconnect
     // if(_wifiAutoReconnect){
-      // @todo move to seperate method, used for event listener now
+      WiFi_registerEvents();
+    // }
+  #endif
+}
+
+/**
+ * wait for a condition instead of a fixed delay, bounded by timeout
+ * records the actual wait in the wait stats
+ * condition must be a real sdk signal, keep the fixed delay where there is none
+ * @since $dev
+ * @param  std::function<bool()> ready   condition
+ * @param  unsigned long          timeout ms, the old fixed delay
+ * @param  wm_wait_id_t           id      stats slot
+ * @return bool                   ready before timeout
+ */
+bool WiFiManager::waitFor(std::function<bool()> ready, unsigned long timeout, wm_wait_id_t id){
+  unsigned long start = millis();
+  bool ret;
+  while(!(ret = ready()) && millis() - start < timeout){
+    delay(1);
+  }
+  uint32_t ms = millis() - start;
+  wm_wait_stats_t &stats = _waitStats[id];
+  stats.last = ms;
+  stats.max  = std::max(stats.max,ms);
+  stats.count++;
+  if(!ret) stats.timeouts++;
+  #ifdef WM_DEBUG_LEVEL
+  DEBUG_WM(WM_DEBUG_DEV,F("waitFor ms:"),(String)ms + (ret ? "" : " timeout") + " id:" + (String)id);
+  #endif
+  return ret;
+}
+
+/**
+ * softap is up and has an ip, esp32 from the core ap started bit
+ * the bit is set on the ap start event and stays set while the ap runs
+ * @since $dev
+ * @return bool ready
+ */
+bool WiFiManager::apReady(){
+  if((WiFi.getMode() & WIFI_AP) == 0) return false;
+  #ifdef ESP32
+  if(!(WiFi.getStatusBits() & AP_STARTED_BIT)) return false;
+  #endif
+  return WiFi.softAPIP() != IPAddress(0,0,0,0);
+}
+
+/**
+ * sta connect status, terminal failures from esp8266 station status or esp32 events
+ * @since $dev
+ * @return uint8_t WL_CONNECTED, WL_CONNECT_FAILED, WL_NO_SSID_AVAIL or current status while connecting
+ */
+uint8_t WiFiManager::WiFi_connectStatus(){
+  uint8_t status = WiFi.status();
+  if(status == WL_CONNECTED || status == WL_CONNECT_FAILED || status == WL_NO_SSID_AVAIL) return status;
+  #ifdef ESP8266
+  station_status_t sta = wifi_station_get_connect_status();
+  if(sta == STATION_WRONG_PASSWORD || sta == STATION_CONNECT_FAIL) return WL_CONNECT_FAILED;
+  if(sta == STATION_NO_AP_FOUND) return WL_NO_SSID_AVAIL;
+  #elif defined(ESP32)
+  if(_conxFail != WL_IDLE_STATUS) return _conxFail;
+  #endif
+  return status;
+}
+
+/**
+ * clear the previous attempt's terminal failure and pending wakeups
+ * call before begin, events can arrive before begin returns
+ * @since $dev
+ */
+void WiFiManager::WiFi_connectStatusReset(){
+  #ifdef ESP32
+  _conxFail = WL_IDLE_STATUS;
+  if(_conxEvent) xSemaphoreTake(_conxEvent,0); // drop stale events
+  #endif
+}
+
+/**
+ * register esp32 wifi event handler, once
+ * used for connect results, connect waits and async scans
+ * @since $dev
+ */
+void WiFiManager::WiFi_registerEvents(){
+  #ifdef ESP8266
+    if(_staConnectedHandler) return;
+    _staConnectedHandler    = WiFi.onStationModeConnected([this](const WiFiEventStationModeConnected &){ if(_conxCur) _conxCur->assoc = millis(); });
+    _staGotIPHandler        = WiFi.onStationModeGotIP([this](const WiFiEventStationModeGotIP &){ if(_conxCur) _conxCur->gotip = millis(); });
+    _staDisconnectedHandler = WiFi.onStationModeDisconnected([this](const WiFiEventStationModeDisconnected &evt){ if(_conxCur) _conxCur->reason = evt.reason; });
+  #elif defined(ESP32)
+    if(!_conxEvent) _conxEvent = xSemaphoreCreateBinary();
+    if(wm_event_id != 0) return;
+    #ifdef WM_DEBUG_LEVEL
+    DEBUG_WM(WM_DEBUG_VERBOSE,F("ESP32 event handler enabled"));
+    #endif
+    using namespace std::placeholders;
+    wm_event_id = WiFi.onEvent(std::bind(&WiFiManager::WiFiEvent,this,_1,_2));
+  #endif
+}
+
+/**
+ * load credential store from flash, once
+ * @since $dev
+ * @return bool store available
+ */
+bool WiFiManager::credLoad(){
+  if(_creds) return true;
+  _creds.reset(new wm_credstore_t);
+  if(!_creds) return false;
+  if(!storeRead("creds",_creds.get(),sizeof(wm_credstore_t),1) || _creds->count > WM_MAX_CREDENTIALS){
+    memset(_creds.get(),0,sizeof(wm_credstore_t));
+  }
+  #ifdef WM_DEBUG_LEVEL
+  DEBUG_WM(WM_DEBUG_VERBOSE,F("Credential store networks:"),_creds->count);
+  #endif
+  return true;
+}
+
+/**
+ * save credential store to flash, ram only on esp8266 cores without LittleFS
+ * @since $dev
+ * @return bool success
+ */
+bool WiFiManager::credSave(){
+  if(!_creds) return false;
+  #if defined(WM_FLASHSTORE) || defined(WM_CREDSTORE_FLASH)
+  return storeWrite("creds",_creds.get(),sizeof(wm_credstore_t),1);
+  #else
+  return false;
+  #endif
+}
+
+/**
+ * find network in credential store
+ * @since $dev
+ * @param  const char* ssid
+ * @return int index, -1 not found
+ */
+int WiFiManager::credFind(const char* ssid){
+  if(!ssid || !credLoad()) return -1;
+  for(uint8_t i=0; i<_creds->count; i++){
+    if(strncmp(_creds->entries[i].ssid,ssid,sizeof(_creds->entries[i].ssid)) == 0) return i;
+  }
+  return -1;
+}
+
+/**
+ * add or update a network, replaces the least recently successful when full
+ * only saved when changed
+ * @since $dev
+ * @param  const char* ssid
+ * @param  const char* pass
+ * @param  bool        success mark as last good connect
+ * @return bool        stored
+ */
+bool WiFiManager::credAdd(const char* ssid, const char* pass, bool success){
+  if(!ssid || !*ssid || strlen(ssid) > 32 || (pass && strlen(pass) > 64) || !credLoad()) return false;
+  if(!pass) pass = "";
+  bool changed = false;
+  int i = credFind(ssid);
+  if(i < 0){
+    if(_creds->count < WM_MAX_CREDENTIALS) i = _creds->count++;
+    else {
+      i = 0;
+      for(uint8_t j=1; j<_creds->count; j++){
+        if(_creds->entries[j].lastok < _creds->entries[i].lastok) i = j;
+      }
       #ifdef WM_DEBUG_LEVEL
-      DEBUG_WM(WM_DEBUG_VERBOSE,F("ESP32 event handler enabled"));
+      DEBUG_WM(WM_DEBUG_VERBOSE,F("Credential store full, replacing:"),_creds->entries[i].ssid);
       #endif
-      using namespace std::placeholders;
-      if(wm_event_id == 0) wm_event_id = WiFi.onEvent(std::bind(&WiFiManager::WiFiEvent,this,_1,_2));
-    // }
+    }
+    memset(&_creds->entries[i],0,sizeof(wm_credential_t));
+    strncpy(_creds->entries[i].ssid,ssid,sizeof(_creds->entries[i].ssid) - 1);
+    changed = true;
+  }
+  wm_credential_t &cred = _creds->entries[i];
+  if(strcmp(cred.pass,pass) != 0){
+    strncpy(cred.pass,pass,sizeof(cred.pass) - 1);
+    changed = true;
+  }
+  if(success && (cred.lastok == 0 || cred.lastok != _creds->seq)){
+    cred.lastok = ++_creds->seq;
+    changed = true;
+  }
+  return changed ? credSave() : true;
+}
+
+/**
+ * add the sdk saved network to the credential store, migrates existing setups
+ * @since $dev
+ */
+void WiFiManager::credMigrate(){
+  String saved = WiFi_SSID(true);
+  if(saved == "" || credFind(saved.c_str()) >= 0) return;
+  #ifdef WM_DEBUG_LEVEL
+  DEBUG_WM(WM_DEBUG_VERBOSE,F("Credential store, adding saved network:"),saved);
+  #endif
+  credAdd(saved.c_str(),WiFi_psk(true).c_str(),false);
+}
+
+/**
+ * clear credential store
+ * @since $dev
+ */
+void WiFiManager::credClear(){
+  if(_creds) memset(_creds.get(),0,sizeof(wm_credstore_t));
+  storeRemove("creds");
+}
+
+/**
+ * load rtc cache, esp8266 rtc user memory, esp32 rtc noinit memory
+ * invalid or power on garbage is cleared
+ * @since $dev
+ * @return bool valid
+ */
+bool WiFiManager::rtcLoad(){
+  if(_rtcLoaded) return _rtc.magic == WM_RTC_MAGIC;
+  _rtcLoaded = true;
+  #ifdef ESP8266
+  bool ret = ESP.rtcUserMemoryRead(WM_RTC_OFFSET,(uint32_t*)&_rtc,sizeof(_rtc));
+  #elif defined(ESP32)
+  memcpy(&_rtc,&wm_rtcmem,sizeof(_rtc));
+  bool ret = true;
+  #endif
+  if(!ret || _rtc.magic != WM_RTC_MAGIC || _rtc.len != sizeof(_rtc) || _rtc.crc != wm_crc32((uint8_t*)&_rtc + 4,sizeof(_rtc) - 4)){
+    #ifdef WM_DEBUG_LEVEL
+    DEBUG_WM(WM_DEBUG_VERBOSE,F("rtc cache empty"));
+    #endif
+    memset(&_rtc,0,sizeof(_rtc));
+    return false;
+  }
+  return true;
+}
+
+/**
+ * fast boot fingerprint of the config autoConnect applies before connecting
+ * @since $dev
+ * @return uint32_t crc32, never 0
+ */
+uint32_t WiFiManager::fastBootFingerprint(){
+  String cfg = _hostname + '|' + _wificountry + '|' + (String)_wifiAutoReconnect + (String)_reconnPolicy;
+  uint32_t crc = wm_crc32(cfg.c_str(),cfg.length());
+  return crc ? crc : 1;
+}
+
+/**
+ * save rtc cache
+ * @since $dev
+ * @return bool success
+ */
+bool WiFiManager::rtcSave(){
+  _rtcLoaded = true;
+  _rtc.magic = WM_RTC_MAGIC;
+  _rtc.len   = sizeof(_rtc);
+  _rtc.crc   = wm_crc32((uint8_t*)&_rtc + 4,sizeof(_rtc) - 4);
+  #ifdef ESP8266
+  return ESP.rtcUserMemoryWrite(WM_RTC_OFFSET,(uint32_t*)&_rtc,sizeof(_rtc));
+  #elif defined(ESP32)
+  memcpy(&wm_rtcmem,&_rtc,sizeof(_rtc));
+  return true;
+  #endif
+}
+
+/**
+ * record persists in the flash store, without WM_FLASHSTORE only the credential store is kept
+ * @since $dev
+ * @param  const char *key
+ * @return bool
+ */
+bool WiFiManager::storeKeyAllowed(const char *key){
+  #ifdef WM_FLASHSTORE
+  return true;
+  #else
+  return strcmp(key,"creds") == 0;
+  #endif
+}
+
+/**
+ * mount flash store, WM_FLASHSTORE or the credential store
+ * esp8266 never formats, the filesystem must already be LittleFS
+ * @since $dev
+ * @return bool success
+ */
+bool WiFiManager::storeBegin(){
+  #if defined(WM_FLASHSTORE) || defined(WM_CREDSTORE_FLASH)
+  if(_storeBegun) return true;
+  #ifdef ESP8266
+  LittleFSConfig cfg;
+  cfg.setAutoFormat(false);
+  LittleFS.setConfig(cfg); // fails harmlessly if already mounted by the sketch
+  _storeBegun = LittleFS.begin();
+  #elif defined(ESP32)
+  _storeBegun = _prefs.begin("wifimanager",false);
+  #endif
+  #ifdef WM_DEBUG_LEVEL
+  if(!_storeBegun) DEBUG_WM(WM_DEBUG_ERROR,F("[ERROR] flash store begin failed"));
+  #endif
+  return _storeBegun;
+  #else
+  return false;
+  #endif
+}
+
+/**
+ * read a flash store record
+ * @since $dev
+ * @param  const char *key  record key, max 15 chars
+ * @param  void       *data out, undefined on failure
+ * @param  size_t      len  record length, must match stored
+ * @param  uint16_t    ver  record version, must match stored
+ * @return bool        valid record read
+ */
+bool WiFiManager::storeRead(const char *key, void *data, size_t len, uint16_t ver){
+  #if defined(WM_FLASHSTORE) || defined(WM_CREDSTORE_FLASH)
+  if(!storeKeyAllowed(key)) return false;
+  if(!storeBegin()) return false;
+  wm_store_hdr_t hdr;
+  bool ret = false;
+  #ifdef ESP8266
+  String path = String(F("/wm/")) + key;
+  if(!LittleFS.exists(path)) return false;
+  File f = LittleFS.open(path,"r");
+  if(f){
+    ret = f.read((uint8_t*)&hdr,sizeof(hdr)) == sizeof(hdr) && hdr.len == len && f.read((uint8_t*)data,len) == len;
+    f.close();
+  }
+  #elif defined(ESP32)
+  if(_prefs.getBytesLength(key) != sizeof(hdr) + len) return false;
+  std::vector<uint8_t> buf(sizeof(hdr) + len);
+  ret = _prefs.getBytes(key,buf.data(),buf.size()) == buf.size();
+  if(ret){
+    memcpy(&hdr,buf.data(),sizeof(hdr));
+    memcpy(data,buf.data() + sizeof(hdr),len);
+  }
+  #endif
+  ret = ret && hdr.magic == WM_STORE_MAGIC && hdr.ver == ver && hdr.len == len && hdr.crc == wm_crc32(data,len);
+  #ifdef WM_DEBUG_LEVEL
+  if(!ret) DEBUG_WM(WM_DEBUG_VERBOSE,F("flash store record invalid:"),key);
+  #endif
+  return ret;
+  #else
+  return false;
+  #endif
+}
+
+/**
+ * write a flash store record, header with crc for validation on read
+ * @since $dev
+ * @param  const char *key  record key, max 15 chars
+ * @param  const void *data
+ * @param  size_t      len
+ * @param  uint16_t    ver  record version
+ * @return bool        success
+ */
+bool WiFiManager::storeWrite(const char *key, const void *data, size_t len, uint16_t ver){
+  #if defined(WM_FLASHSTORE) || defined(WM_CREDSTORE_FLASH)
+  if(!storeKeyAllowed(key)) return false;
+  if(!storeBegin()) return false;
+  wm_store_hdr_t hdr;
+  hdr.crc   = wm_crc32(data,len);
+  hdr.magic = WM_STORE_MAGIC;
+  hdr.ver   = ver;
+  hdr.len   = len;
+  bool ret  = false;
+  #ifdef ESP8266
+  File f = LittleFS.open(String(F("/wm/")) + key,"w");
+  if(f){
+    ret = f.write((const uint8_t*)&hdr,sizeof(hdr)) == sizeof(hdr) && f.write((const uint8_t*)data,len) == len;
+    f.close();
+  }
+  #elif defined(ESP32)
+  std::vector<uint8_t> buf(sizeof(hdr) + len);
+  memcpy(buf.data(),&hdr,sizeof(hdr));
+  memcpy(buf.data() + sizeof(hdr),data,len);
+  ret = _prefs.putBytes(key,buf.data(),buf.size()) == buf.size();
+  #endif
+  #ifdef WM_DEBUG_LEVEL
+  if(!ret) DEBUG_WM(WM_DEBUG_ERROR,F("[ERROR] flash store write failed:"),key);
+  #endif
+  return ret;
+  #else
+  return false;
+  #endif
+}
+
+/**
+ * remove a flash store record
+ * @since $dev
+ * @param  const char *key
+ * @return bool success
+ */
+bool WiFiManager::storeRemove(const char *key){
+  #if defined(WM_FLASHSTORE) || defined(WM_CREDSTORE_FLASH)
+  if(!storeKeyAllowed(key)) return false;
+  if(!storeBegin()) return false;
+  #ifdef ESP8266
+  String path = String(F("/wm/")) + key;
+  return !LittleFS.exists(path) || LittleFS.remove(path);
+  #elif defined(ESP32)
+  return !_prefs.isKey(key) || _prefs.remove(key);
+  #endif
+  #else
+  return false;
   #endif
 }
 
@@ -3949,6 +7059,7 @@ void WiFiManager::handleUpdating(){
   // UPLOAD START
 	if (upload.status == UPLOAD_FILE_START) {
 	  // if(_debug) Serial.setDebugOutput(true);
+    _otaInProgress = true; // hold background scans
     uint32_t maxSketchSpace;
     
     // Use new callback for before OTA update
@@ -4013,6 +7124,7 @@ void WiFiManager::handleUpdating(){
     error = true;
   }
   if(error) _configPortalTimeout = _configPortalTimeoutSAV;
+  if(error || upload.status == UPLOAD_FILE_END) _otaInProgress = false;
 	delay(0);
 }
 
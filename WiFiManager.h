@@ -21,11 +21,14 @@
 #endif
 
 #include <vector>
+#include <algorithm>
 
 // #define WM_MDNS            // includes MDNS, also set MDNS with sethostname
 // #define WM_FIXERASECONFIG  // use erase flash fix
 // #define WM_ERASE_NVS       // esp32 erase(true) will erase NVS 
 // #define WM_RTC             // esp32 info page will include reset reasons
+// #define WM_FLASHSTORE      // persist connect caches to flash, esp32 nvs Preferences, esp8266 LittleFS (must be LittleFS formatted)
+                              // without it the credential store still persists, esp32 nvs, esp8266 LittleFS (core 2.7+, else ram only)
 
 // #define WM_JSTEST                      // build flag for enabling js xhr tests
 // #define WIFI_MANAGER_OVERRIDE_STRINGS // build flag for using own strings include
@@ -37,6 +40,7 @@
 #define WM_NOCOUNTRY       // esp8266 no country
 #define WM_NOAUTH          // no httpauth
 #define WM_NOSOFTAPSSID    // no softapssid() @todo shim
+#define WM_NOSCANFILTER    // esp8266 no channel or ssid scan filter
 #endif
 
 // #ifdef CONFIG_IDF_TARGET_ESP32S2
@@ -77,6 +81,16 @@
         #include <ESP8266mDNS.h>
     #endif
 
+    #if !defined(WM_FLASHSTORE) && defined(ARDUINO_ESP8266_MAJOR)
+        #define WM_CREDSTORE_FLASH // credential store persists to LittleFS in the default build, LittleFS is part of the core
+    #endif
+    #if defined(WM_FLASHSTORE) || defined(WM_CREDSTORE_FLASH)
+        #include <LittleFS.h>
+    #endif
+
+    #include <lwip/init.h>
+    #include <lwip/dhcp.h> // dhcp cache lease check
+
     #define WIFI_getChipId() ESP.getChipId() 
     #define WM_WIFIOPEN   ENC_TYPE_NONE
 
@@ -108,6 +122,11 @@
         #include <ESPmDNS.h>
     #endif
 
+    #ifndef WM_FLASHSTORE
+        #define WM_CREDSTORE_FLASH // credential store persists to nvs in the default build, Preferences is part of the core
+    #endif
+    #include <Preferences.h>
+
     #ifdef WM_RTC
         #ifdef ESP_IDF_VERSION_MAJOR // IDF 4+
         #if CONFIG_IDF_TARGET_ESP32 // ESP32/PICO-D4
@@ -131,6 +150,8 @@
 
 #include <DNSServer.h>
 #include <memory>
+#include <new>
+#include <type_traits>
 
 
 // Include wm strings vars
@@ -197,11 +218,42 @@
     #define WIFI_MANAGER_MAX_PARAMS 5 // params will autoincrement and realloc by this amount when max is reached
 #endif
 
+#ifndef WM_RTC_OFFSET
+    #define WM_RTC_OFFSET 96 // esp8266 rtc user memory block (4 bytes) for wm cache, blocks 0-31 are used by eboot ota
+#endif
+
+#ifndef WM_CONX_HISTORY
+    #define WM_CONX_HISTORY 4 // connect timelines kept
+#endif
+
+#ifndef WM_SCAN_TIMEOUT
+    #define WM_SCAN_TIMEOUT 10000 // ms a scan may run before it is given up
+#endif
+
+#ifndef WM_DHCP_CONFIRM_TIMEOUT
+    #define WM_DHCP_CONFIRM_TIMEOUT 10000 // ms for a dhcp lease to confirm a cached ip config
+#endif
+
+#ifndef WM_MAX_CREDENTIALS
+    #define WM_MAX_CREDENTIALS 4 // networks kept in the credential store
+#endif
+
+#define WM_RTC_MAGIC   0x574D // rtc cache record magic
+#define WM_STORE_MAGIC 0x5753 // flash store record magic
+#define WM_PARAM_MAGIC 0x5750 // live parameter, cleared by the destructor
+
 #define WFM_LABEL_BEFORE 1
 #define WFM_LABEL_AFTER 2
 #define WFM_NO_LABEL 0
 #define WFM_LABEL_DEFAULT 1
 
+#define WM_PARAM_EXTERNAL 0 // parameter owned by the sketch
+#define WM_PARAM_ARENA    1 // parameter owned by wifimanager, in the parameter arena
+#define WM_PARAM_HEAP     2 // parameter owned by wifimanager, arena full or not reserved
+
+#define WM_PARAM_PGM_LABEL  1 // label is in flash
+#define WM_PARAM_PGM_CUSTOM 2 // custom html is in flash
+
 class WiFiManagerParameter {
   public:
     /** 
@@ -214,32 +266,238 @@ class WiFiManagerParameter {
     WiFiManagerParameter(const char *id, const char *label, const char *defaultValue, int length);
     WiFiManagerParameter(const char *id, const char *label, const char *defaultValue, int length, const char *custom);
     WiFiManagerParameter(const char *id, const char *label, const char *defaultValue, int length, const char *custom, int labelPlacement);
-    ~WiFiManagerParameter();
-    // WiFiManagerParameter& operator=(const WiFiManagerParameter& rhs);
+    // label and custom html read from flash when rendered, F("..") or FPSTR(), ids stay in ram for lookups
+    WiFiManagerParameter(const __FlashStringHelper *custom);
+    WiFiManagerParameter(const char *id, const __FlashStringHelper *label, const char *defaultValue, int length, const __FlashStringHelper *custom = NULL, int labelPlacement = WFM_LABEL_DEFAULT);
+    // value bound to a char array, see bindValue, no value buffer is allocated
+    template<size_t N>
+    WiFiManagerParameter(const char *id, const char *label, char (&buffer)[N], const char *custom = "", int labelPlacement = WFM_LABEL_DEFAULT)
+      : WiFiManagerParameter(id, label, N - 1, custom, labelPlacement) { bindValue(buffer, N); }
+    virtual ~WiFiManagerParameter();
+
+    // movable, the value buffer moves with the parameter, copies would share it
+    WiFiManagerParameter(WiFiManagerParameter &&other);
+    WiFiManagerParameter& operator=(WiFiManagerParameter &&other);
+    WiFiManagerParameter(const WiFiManagerParameter&) = delete;
+    WiFiManagerParameter& operator=(const WiFiManagerParameter&) = delete;
 
     const char *getID() const;
-    const char *getValue() const;
-    const char *getLabel() const;
+    const char *getValue() const;       // never NULL, "" for typed parameters, see getValueString
+    const char *getLabel() const;       // PGM_P if set from flash, see getLabelString
     const char *getPlaceholder() const; // @deprecated, use getLabel
     int         getValueLength() const;
     int         getLabelPlacement() const;
     virtual const char *getCustomHTML() const;
     void        setValue(const char *defaultValue, int length);
+    // bind to an application buffer of size bytes, rendered from and saved into it in place, no value copy
+    // its current content is kept as the value, the buffer must outlive the parameter
+    void        bindValue(char *buffer, size_t size);
+    void        setLabel(const char *label);
+    void        setLabel(const __FlashStringHelper *label);
+    void        setCustomHTML(const char *custom);
+    void        setCustomHTML(const __FlashStringHelper *custom);
+    String      getLabelString() const;      // label from ram or flash
+    String      getCustomHTMLString() const; // custom html from ram or flash
+
+    // device side validation of submitted values, rejected values keep the current value
+    void        setValidator(std::function<bool(const String &value)> validator);
+    virtual bool        validate(const String &value) const;  // check a submitted value
+    virtual bool        setValueFromArg(const String &value); // validate and store a submitted value
+    virtual String      getValueString() const;               // value as text, as saved and exported
+    virtual String      getInputValue() const;                // value attribute rendered in the form
+    virtual String      getInputAttributes() const;           // input type attributes, rendered before custom html
+    virtual const char *getInputTemplate() const;             // form item html template, PROGMEM
+    virtual String      getInputOptions() const;              // select options html, {o} token
+
+    // binary value record, WiFiManager::setParamStore
+    virtual size_t      getStoreSize() const;                 // record bytes, 0 not stored
+    virtual void        getStoreValue(uint8_t *buf) const;    // write record
+    virtual bool        setStoreValue(const uint8_t *buf);    // load record, false if rejected
+
+    // section sub-page of /param, NULL renders on the main param page (and wifi page)
+    void        setSection(const char *section);
+    const char *getSection() const;
+
+    // change tracking, set when the last portal save changed the value
+    bool        isDirty() const;
+    void        setChangedCallback(std::function<void(WiFiManagerParameter *param)> func);
 
   protected:
+    WiFiManagerParameter(const char *id, const char *label, int length, const char *custom, int labelPlacement); // no value buffer, typed parameters
     void init(const char *id, const char *label, const char *defaultValue, int length, const char *custom, int labelPlacement);
 
-    WiFiManagerParameter& operator=(const WiFiManagerParameter&);
     const char *_id;
     const char *_label;
     char       *_value;
     int         _length;
     int         _labelPlacement;
+    bool        _ownsValue = true; // _value allocated here, false for fixed buffers
+    uint8_t     _storage   = WM_PARAM_EXTERNAL; // who owns the parameter itself
+    uint16_t    _magic     = WM_PARAM_MAGIC; // 0 once destroyed, see WiFiManager::paramValid
+    uint32_t    _storeCrc  = 0;    // crc of the record last loaded or stored, 0 unknown
+    bool        _dirty     = false; // changed by the last portal save
   
     const char *_customHTML;
+    const char *_section   = NULL;
+    uint8_t     _progmem   = 0;    // WM_PARAM_PGM_x, strings in flash
+    std::function<bool(const String &value)> _validator;
+    std::function<void(WiFiManagerParameter *param)> _changedcallback;
     friend class WiFiManager;
 };
 
+// typed parameter conversions, parse a submitted value, render value and input attributes
+// specialize for custom types
+template<typename T> struct WiFiManagerParameterTraits;
+
+template<> struct WiFiManagerParameterTraits<int> {
+  static const int length = 11;
+  static const size_t storeSize = sizeof(int32_t);
+  static void   store(const int &value, uint8_t *buf){ int32_t v = value; memcpy(buf, &v, sizeof(v)); }
+  static void   load(const uint8_t *buf, int &value){ int32_t v; memcpy(&v, buf, sizeof(v)); value = v; }
+  static bool   parse(const String &str, int &value);
+  static String toString(const int &value){ return String(value); }
+  static String attributes(const int &value, const int &min, const int &max, bool ranged);
+  static bool   inRange(const int &value, const int &min, const int &max){ return value >= min && value <= max; }
+};
+
+template<> struct WiFiManagerParameterTraits<float> {
+  static const int length = 16;
+  static const size_t storeSize = sizeof(float);
+  static void   store(const float &value, uint8_t *buf){ memcpy(buf, &value, sizeof(value)); }
+  static void   load(const uint8_t *buf, float &value){ memcpy(&value, buf, sizeof(value)); }
+  static bool   parse(const String &str, float &value);
+  static String toString(const float &value);
+  static String attributes(const float &value, const float &min, const float &max, bool ranged);
+  static bool   inRange(const float &value, const float &min, const float &max){ return value >= min && value <= max; }
+};
+
+template<> struct WiFiManagerParameterTraits<bool> {
+  static const int length = 1;
+  static const size_t storeSize = 1;
+  static void   store(const bool &value, uint8_t *buf){ buf[0] = value; }
+  static void   load(const uint8_t *buf, bool &value){ value = buf[0] != 0; }
+  static bool   parse(const String &str, bool &value);
+  static String toString(const bool &value){ return value ? F("1") : F("0"); }
+  static String attributes(const bool &value, const bool &min, const bool &max, bool ranged);
+  static bool   inRange(const bool &value, const bool &min, const bool &max){ (void)value; (void)min; (void)max; return true; }
+};
+
+template<> struct WiFiManagerParameterTraits<IPAddress> {
+  static const int length = 15;
+  static const size_t storeSize = sizeof(uint32_t);
+  static void   store(const IPAddress &value, uint8_t *buf){ uint32_t v = value; memcpy(buf, &v, sizeof(v)); }
+  static void   load(const uint8_t *buf, IPAddress &value){ uint32_t v; memcpy(&v, buf, sizeof(v)); value = IPAddress(v); }
+  static bool   parse(const String &str, IPAddress &value){ return value.fromString(str); }
+  static String toString(const IPAddress &value){ return value.toString(); }
+  static String attributes(const IPAddress &value, const IPAddress &min, const IPAddress &max, bool ranged);
+  static bool   inRange(const IPAddress &value, const IPAddress &min, const IPAddress &max){ (void)value; (void)min; (void)max; return true; }
+};
+
+/**
+ * typed parameter, submitted values are parsed straight into native storage
+ * and checked against min/max and the validator, use get() instead of getValue()
+ * getValue() returns "" for typed parameters, getValueString() returns the value as text
+ */
+template<typename T>
+class WiFiManagerParameterT : public WiFiManagerParameter {
+  public:
+    typedef WiFiManagerParameterTraits<T> Traits;
+
+    WiFiManagerParameterT(const char *id, const char *label, T defaultValue, const char *custom = "", int labelPlacement = WFM_LABEL_DEFAULT)
+      : WiFiManagerParameter(id, label, Traits::length, custom, labelPlacement), _native(defaultValue), _min(defaultValue), _max(defaultValue), _ranged(false), _ref(&_native) {}
+    WiFiManagerParameterT(const char *id, const char *label, T defaultValue, T min, T max, const char *custom = "", int labelPlacement = WFM_LABEL_DEFAULT)
+      : WiFiManagerParameter(id, label, Traits::length, custom, labelPlacement), _native(defaultValue), _min(min), _max(max), _ranged(true), _ref(&_native) {}
+    WiFiManagerParameterT(WiFiManagerParameterT &&other)
+      : WiFiManagerParameter(std::move(other)), _native(other._native), _min(other._min), _max(other._max), _ranged(other._ranged),
+        _ref(other._ref == &other._native ? &_native : other._ref) {}
+    WiFiManagerParameterT& operator=(WiFiManagerParameterT &&other) = delete;
+
+    // bind to an application variable, rendered from and saved into it in place, its current value is kept
+    // the variable must outlive the parameter
+    void     bindValue(T &variable){ _ref = &variable; }
+
+    T        get() const { return *_ref; }
+    bool     set(const T &value){
+      if(_ranged && !Traits::inRange(value, _min, _max)) return false;
+      *_ref = value;
+      return true;
+    }
+    operator T() const { return *_ref; }
+
+    bool   validate(const String &value) const override { T v; return parseArg(value, v); }
+    bool   setValueFromArg(const String &value) override {
+      T v;
+      if(!parseArg(value, v)) return false;
+      *_ref = v;
+      return true;
+    }
+    String getValueString() const override { return Traits::toString(*_ref); }
+    String getInputValue() const override { return getValueString(); }
+    String getInputAttributes() const override { return Traits::attributes(*_ref, _min, _max, _ranged); }
+    size_t getStoreSize() const override { return Traits::storeSize; }
+    void   getStoreValue(uint8_t *buf) const override { Traits::store(*_ref, buf); }
+    bool   setStoreValue(const uint8_t *buf) override {
+      T v;
+      Traits::load(buf, v);
+      return set(v);
+    }
+
+  protected:
+    bool parseArg(const String &value, T &v) const {
+      return Traits::parse(value, v) && (!_ranged || Traits::inRange(v, _min, _max)) && WiFiManagerParameter::validate(value);
+    }
+
+    T     _native;
+    T     _min;
+    T     _max;
+    bool  _ranged;
+    T    *_ref;    // value storage, _native or a bound variable
+};
+
+// checkbox value is always 1, the state is the checked attribute
+template<> inline String WiFiManagerParameterT<bool>::getInputValue() const { return F("1"); }
+
+/**
+ * select parameter, renders a select of options, value is the selected option index
+ * options is an array of count labels that must outlive the parameter, cast get() to an enum as needed
+ */
+class WiFiManagerParameterSelect : public WiFiManagerParameterT<int> {
+  public:
+    WiFiManagerParameterSelect(const char *id, const char *label, const char * const *options, uint8_t count, int defaultValue = 0, const char *custom = "", int labelPlacement = WFM_LABEL_DEFAULT);
+
+    const char *getOption() const; // selected option label
+
+    String      getInputAttributes() const override;
+    const char *getInputTemplate() const override;
+    String      getInputOptions() const override;
+
+  protected:
+    const char * const *_options;
+    uint8_t             _count;
+};
+
+/**
+ * fixed length string parameter, value is kept in an N+1 buffer inside the parameter, no heap
+ */
+template<size_t N>
+class WiFiManagerParameterString : public WiFiManagerParameter {
+  public:
+    WiFiManagerParameterString(const char *id, const char *label, const char *defaultValue = "", const char *custom = "", int labelPlacement = WFM_LABEL_DEFAULT)
+      : WiFiManagerParameter(id, label, N, custom, labelPlacement) {
+      _value     = _buf;
+      _ownsValue = false;
+      setValue(defaultValue, N);
+    }
+    WiFiManagerParameterString(WiFiManagerParameterString &&other)
+      : WiFiManagerParameter(std::move(other)) {
+      memcpy(_buf, other._buf, sizeof(_buf));
+      if(other._value == other._buf) _value = _buf; // else bound with bindValue
+    }
+
+  protected:
+    char _buf[N + 1];
+};
+
 
     // debugging
     typedef enum {
@@ -251,6 +509,132 @@ class WiFiManagerParameter {
         WM_DEBUG_MAX       = 5  // MAX extra dev auditing, var dumps etc (MAX+1 will print timing,mem and frag info)
     } wm_debuglevel_t;
 
+    // readiness waits on sdk signals, replace fixed delays
+    typedef enum {
+        WM_WAIT_WIFIOFF     = 0, // esp32 autoconnect wifi off before hostname
+        WM_WAIT_STAMODE     = 1, // esp32 wifiConnectDefault sta started
+        WM_WAIT_HOSTNAME    = 2, // setupHostname disconnect
+        WM_WAIT_RESET       = 3, // esp32 resetSettings sta started
+        WM_WAIT_ERASE       = 4, // esp32 eraseConfig sta stopped
+        WM_WAIT_APIP        = 5, // startConfigPortal softap up with ip, before the ap callback
+        WM_WAIT_MAX
+    } wm_wait_id_t;
+
+    typedef struct {
+        uint32_t    last     = 0;       // ms last wait
+        uint32_t    max      = 0;       // ms longest wait
+        uint32_t    count    = 0;       // waits
+        uint32_t    timeouts = 0;       // waits that hit the timeout
+    } wm_wait_stats_t;
+
+    // reconnect policy counters
+    typedef struct {
+        uint32_t    attempts  = 0;      // reconnect attempts
+        uint32_t    outages   = 0;      // sta connection losses
+        uint32_t    offlineMs = 0;      // ms offline total, including the current outage
+        uint32_t    outageMs  = 0;      // ms offline in the current outage, 0 when connected
+        uint32_t    nextMs    = 0;      // ms backoff before the next attempt
+        uint8_t     portals   = 0;      // portals started after the outage budget ran out
+    } wm_reconnect_stats_t;
+
+    // autoConnectAsync states
+    typedef enum {
+        WM_ASYNC_IDLE       = 0, // not started
+        WM_ASYNC_CONNECTING = 1, // connect attempt in progress
+        WM_ASYNC_RETRYING   = 2, // waiting to retry
+        WM_ASYNC_PORTAL     = 3, // connect failed, non blocking config portal running
+        WM_ASYNC_CONNECTED  = 4, // connected
+        WM_ASYNC_FAILED     = 5  // connect failed, portal disabled, timed out or closed
+    } wm_async_state_t;
+
+    // wifi scan options, for targeted scans
+    #define WM_SCAN_CHANNEL(ch) (uint16_t)(1 << (ch)) // channel list bit for channel 1-14
+
+    typedef struct {
+        uint16_t    channels = 0;       // channel list bitmask WM_SCAN_CHANNEL(n), 0 for all channels
+        const char* ssid     = nullptr; // directed probe for a single ssid, NULL for all
+        bool        passive  = false;   // passive scan, listen for beacons only (esp32)
+        uint32_t    dwell    = 0;       // ms per channel dwell time, 0 for sdk default (esp32)
+        bool        hidden   = false;   // include hidden networks
+    } wm_scan_opts_t;
+
+    // last good connection, for fast reconnect
+    typedef struct {
+        uint32_t    ssidcrc;            // crc32 of the ssid this entry belongs to
+        uint8_t     bssid[6];           // ap bssid
+        uint8_t     channel;            // ap channel, 0 for none
+        uint8_t     reserved;
+    } wm_fastconx_t;
+
+    // dhcp assigned ip config, reused as provisional static config
+    typedef struct {
+        uint32_t    ssidcrc;            // crc32 of the ssid the lease belongs to
+        uint8_t     bssid[6];           // ap bssid the lease was obtained on
+        uint16_t    uses;               // connects on this cached config
+        uint32_t    ip;
+        uint32_t    gw;
+        uint32_t    sn;
+        uint32_t    dns;
+        uint32_t    dhcpms;             // ms connect time of the dhcp connect that recorded it
+    } wm_ipcache_t;
+
+    // credential store entry
+    typedef struct {
+        char        ssid[33];
+        char        pass[65];
+        uint32_t    lastok;             // success sequence of the last good connect, 0 never
+    } wm_credential_t;
+
+    // credential store, crc checked flash record
+    typedef struct {
+        uint32_t    seq;                // last success sequence
+        uint8_t     count;
+        wm_credential_t entries[WM_MAX_CREDENTIALS];
+    } wm_credstore_t;
+
+    // connect attempt timeline, millis timestamps, 0 if not reached
+    typedef struct {
+        uint32_t    start;              // attempt start
+        uint32_t    mode;               // sta mode set
+        uint32_t    begin;              // begin() called
+        uint32_t    assoc;              // associated and authenticated, the sdk reports both in one event, dhcp starts here
+        uint32_t    gotip;              // got ip, dhcp done
+        uint32_t    end;                // wait ended
+        uint8_t     attempt;            // attempt number in connectWifi, 0 for fast connect
+        uint8_t     reason;             // last sdk disconnect reason, 0 none
+        uint8_t     result;             // wl status
+        bool        cachedip;           // ip config from dhcp cache
+    } wm_conx_timeline_t;
+
+    // ip cache stats
+    typedef struct {
+        bool        cached    = false;  // last connect used the cached ip config
+        bool        valid     = false;  // ip config confirmed by a dhcp lease after connect
+        uint16_t    uses      = 0;      // connects on the current cached config
+        uint32_t    connectMs = 0;      // ms connect time of the last connect
+        uint32_t    dhcpMs    = 0;      // ms connect time of the last dhcp connect, for comparison
+    } wm_ipcache_stats_t;
+
+    // rtc memory cache, survives deep sleep (and soft resets on esp32), crc checked
+    typedef struct {
+        uint32_t    crc;                // crc32 of the rest of the record
+        uint16_t    magic;              // WM_RTC_MAGIC
+        uint16_t    len;                // record size, layout changes invalidate the cache
+        wm_fastconx_t conx;             // last good connection
+        wm_ipcache_t  ipc;              // last dhcp ip config
+        uint32_t    bootcfg;            // config fingerprint of the last fast boot
+    } wm_rtc_t;
+
+// added parameters, for(WiFiManagerParameter *p : wm.parameters())
+struct WiFiManagerParameterList {
+    WiFiManagerParameter **_first;
+    int                    _count;
+    WiFiManagerParameter **begin() const { return _first; }
+    WiFiManagerParameter **end()   const { return _first + _count; }
+    int                    size()  const { return _count; }
+    WiFiManagerParameter  *operator[](int i) const { return _first[i]; }
+};
+
 class WiFiManager
 {
   public:
@@ -263,6 +647,14 @@ class WiFiManager
     boolean       autoConnect();
     boolean       autoConnect(char const *apName, char const *apPassword = NULL);
 
+    // non blocking auto connect, advanced by process(), falls back to a non blocking config portal
+    // saved or default ssid only, no credential store or scan gate
+    boolean       autoConnectAsync();
+    boolean       autoConnectAsync(char const *apName, char const *apPassword = NULL);
+
+    // get autoConnectAsync state
+    wm_async_state_t getAsyncState();
+
     //manually start the config portal, autoconnect does this automatically on connect failure
     boolean       startConfigPortal(); // auto generates apname
     boolean       startConfigPortal(char const *apName, char const *apPassword = NULL);
@@ -299,12 +691,42 @@ class WiFiManager
     //adds a custom parameter, returns false on failure
     bool          addParameter(WiFiManagerParameter *p);
 
+    // adds a parameter by value, moved into wifimanager owned storage, returns the owned parameter or NULL
+    // wm.addParameter(WiFiManagerParameterT<int>("port","Port",1883));
+    template<typename P, typename std::enable_if<std::is_base_of<WiFiManagerParameter,typename std::remove_reference<P>::type>::value && !std::is_lvalue_reference<P>::value,int>::type = 0>
+    typename std::remove_reference<P>::type* addParameter(P &&param);
+
+    // reserve parameter slots, and an arena of bytes holding parameters added by value and their values
+    bool          reserveParameters(uint8_t count, size_t bytes = 0);
+
+    // GET/POST /api/config json import/export of parameters, wifi credentials and static ip, for provisioning, default false
+    // the portal has no authentication, only enable on trusted networks
+    void          setConfigApi(boolean enabled);
+
+    // persist parameter values as binary records in the flash store (WM_FLASHSTORE), version invalidates older records
+    void          setParamStore(bool enable, uint16_t version = 0);
+
+    // load stored values into parameters not loaded yet, autoConnect and the portal do this, returns records loaded
+    int           loadParameters();
+
+    // write parameters changed since loaded or stored, portal saves do this, returns records written
+    int           saveParameters();
+
     //returns the list of Parameters
     WiFiManagerParameter** getParameters();
 
     // returns the Parameters Count
     int           getParametersCount();
 
+    // returns the parameter with id, hash index lookup, NULL if not added
+    WiFiManagerParameter* getParameter(const char *id);
+
+    // iterable list of the added parameters
+    WiFiManagerParameterList parameters();
+
+    // returns the number of parameters changed by the last portal save
+    int           getParamsChanged();
+
     // SET CALLBACKS
 
     //called after AP mode and config portal has started
@@ -328,12 +750,21 @@ class WiFiManager
     //called when saving either params-in-wifi or params page
     void          setSaveParamsCallback( std::function<void()> func );
 
+    //called for each parameter whose value changed on save, before the save params callback
+    void          setParamChangedCallback( std::function<void(WiFiManagerParameter*)> func );
+
+    //only call the save params callback when a parameter value changed, default false
+    void          setSaveParamsOnChange(boolean enabled);
+
     //called just before doing OTA update
     void          setPreOtaUpdateCallback( std::function<void()> func );
 
     //called when config portal is timeout
     void          setConfigPortalTimeoutCallback( std::function<void()> func );
 
+    //called when autoConnectAsync changes state, connected, portal started or failed
+    void          setAsyncConnectCallback( std::function<void(wm_async_state_t)> func );
+
     //sets timeout before AP,webserver loop ends and exits even if there has been no setup.
     //useful for devices that failed to connect at some point and got stuck in a webserver loop
     //in seconds setConfigPortalTimeout is a new name for setTimeout, ! not used if setConfigPortalBlocking
@@ -379,18 +810,28 @@ class WiFiManager
     
     //add custom html at inside <head> for all pages
     void          setCustomHeadElement(const char* html);
+    void          setCustomHeadElement(const __FlashStringHelper* html); // read from flash
 
     //add custom html at start of <body> for all pages
     void          setCustomBodyHeader(const char* html);
+    void          setCustomBodyHeader(const __FlashStringHelper* html);
 
     //add custom html at end of <body> for all pages
     void          setCustomBodyFooter(const char* html);
+    void          setCustomBodyFooter(const __FlashStringHelper* html);
 
     //if this is set, customise style
     void          setCustomMenuHTML(const char* html);
+    void          setCustomMenuHTML(const __FlashStringHelper* html);
 
     //if this is true, remove duplicated Access Points - defaut true
     void          setRemoveDuplicateAPs(boolean removeDuplicates);
+
+    //max number of networks shown in wifi scan, strongest first, 0 for no limit
+    void          setMaxScanNetworks(uint8_t max);
+
+    //paginate wifi scan list, networks per page, adds ssid search and more button, 0 for one page
+    void          setScanPageSize(uint8_t size);
     
     //setter for ESP wifi.persistent so we can remember it and restore user preference, as WIFi._persistent is protected
     void          setRestorePersistent(boolean persistent);
@@ -415,6 +856,10 @@ class WiFiManager
     
     // if true, enable autoreconnecting
     void          setWiFiAutoReconnect(boolean enabled);
+
+    // if true, reconnect from process() with exponential backoff and jitter instead of the sdk autoreconnect
+    // base and max interval in seconds, jitter in percent, portal after outage seconds, 0 never
+    void          setReconnectPolicy(boolean enabled, unsigned long base = 1, unsigned long max = 300, uint8_t jitter = 25, unsigned long outage = 0);
     
     // if true, wifiscan will show percentage instead of quality icons, until we have better templating
     void          setScanDispPerc(boolean enabled);
@@ -481,11 +926,70 @@ class WiFiManager
     void          debugPlatformInfo();
 
     // helper for html
-    String        htmlEntities(String str, bool whitespace = false);
+    static String htmlEntities(String str, bool whitespace = false);
     
     // set the country code for wifi settings, CN
     void          setCountry(String cc);
 
+    // set scan options for portal scans, passive, dwell, hidden (channels and ssid apply to targeted scans only)
+    void          setScanOptions(wm_scan_opts_t opts);
+
+    // background scan scheduler, async scans while portal clients are active, backs off to maxinterval when idle (seconds)
+    void          setBackgroundScan(bool enable, unsigned long interval = 10, unsigned long maxinterval = 120);
+
+    // get ms since last completed scan, 0 if never scanned
+    unsigned long getScanAge();
+
+    // get ms duration of last completed scan
+    unsigned long getScanDuration();
+
+    // fast reconnect, connect to the last good bssid and channel skipping the sdk scan, falls back to a normal connect (timeout seconds)
+    void          setFastConnect(bool enable, unsigned long timeout = 10);
+
+    // scan gate, autoConnect checks the saved network is in range before connecting, skips to the next stored network or portal
+    void          setConnectScanGate(bool enable);
+
+    // fast boot, skip wifi mode toggles and setters in autoConnect that are already applied, for deep sleep duty cycles
+    void          setFastBoot(bool enable);
+
+    // cache the dhcp assigned ip config and reuse it as static config on the next connect, dhcp refresh after maxuses connects
+    // dhcp is restarted in the background after connect, a different or missing lease drops the cache, process() completes the check
+    void          setDHCPCache(bool enable, uint16_t maxuses = 50);
+
+    // get ip cache stats, connect times with and without the cached config
+    wm_ipcache_stats_t getDHCPCacheStats();
+
+    // multiple network credential store, autoConnect scans once and tries stored networks by visibility, rssi and last success (timeout seconds per network)
+    // returns false if the store cannot persist, esp8266 cores without LittleFS
+    bool          setCredentialStore(bool enable, unsigned long timeout = 10);
+
+    // add or update a network in the credential store, least recently used is replaced when full
+    bool          addCredential(const char* ssid, const char* pass = "");
+
+    // remove a network from the credential store
+    bool          removeCredential(const char* ssid);
+
+    // number of networks in the credential store
+    uint8_t       getCredentialCount();
+
+    // get reconnect policy counters
+    wm_reconnect_stats_t getReconnectStats();
+
+    // get readiness wait stats, actual ms spent where fixed delays used to be
+    wm_wait_stats_t getWaitStats(wm_wait_id_t id);
+
+    // get ms from portal start to first request served, 0 if none served yet
+    unsigned long getPortalReadyTime();
+
+    // get ms from the last portal wifi save to connected, 0 if not connected
+    unsigned long getSaveConnectTime();
+
+    // get connect attempt timeline, n=0 newest, false if not recorded
+    bool          getConnectTimeline(wm_conx_timeline_t &timeline, uint8_t n = 0);
+
+    // number of connect timelines kept, up to WM_CONX_HISTORY
+    uint8_t       getConnectTimelineCount();
+
     // set body class (invert), may be used for hacking in alt classes
     void          setClass(String str);
 
@@ -580,6 +1084,8 @@ class WiFiManager
     #ifdef ESP32
     wifi_event_id_t wm_event_id           = 0;
     static uint8_t _lastconxresulttmp; // tmp var for esp32 callback
+    SemaphoreHandle_t _conxEvent          = NULL; // given on sta events, wakes connect waits
+    volatile uint8_t _conxFail            = WL_IDLE_STATUS; // terminal sta failure from events, fast fails connect waits
     #endif
 
     #ifndef WL_STATION_WRONG_PASSWORD
@@ -591,9 +1097,13 @@ class WiFiManager
     int           _staShowStaticFields    = 0;     // ternary 1=always show static ip fields, 0=only if set, -1=never(cannot change ips via web!)
     int           _staShowDns             = 0;     // ternary 1=always show dns, 0=only if set, -1=never(cannot change dns via web!)
     boolean       _removeDuplicateAPs     = true;  // remove dup aps from wifiscan
+    uint8_t       _maxNetworks            = 0;     // max aps shown in wifiscan, strongest first, 0 no limit
+    uint8_t       _scanPageSize           = 0;     // aps per wifiscan page, 0 no paging
     boolean       _showPassword           = false; // show or hide saved password on wifi form, might be a security issue!
     boolean       _shouldBreakAfterConfig = false; // stop configportal on save failure
     boolean       _configPortalIsBlocking = true;  // configportal enters blocking loop 
+    boolean       _configPortalBlockingRestore = false; // internal non blocking portal running, restore blocking setting on close
+    boolean       _configPortalBlockingUser    = true;  // users blocking setting to restore
     boolean       _enableCaptivePortal    = true;  // enable captive portal redirection
     boolean       _userpersistent         = true;  // users preffered persistence to restore
     boolean       _wifiAutoReconnect      = true;  // there is no platform getter for this, we must assume its true and make it so
@@ -612,6 +1122,10 @@ class WiFiManager
     const char*   _customBodyHeader       = ""; // store custom top body element html from user inside <body>
     const char*   _customBodyFooter       = ""; // store custom bottom body element html from user inside <body>
     const char*   _customMenuHTML         = ""; // store custom menu html from user
+    boolean       _customHeadElementP     = false; // custom html above is in flash
+    boolean       _customBodyHeaderP      = false;
+    boolean       _customBodyFooterP      = false;
+    boolean       _customMenuHTMLP        = false;
     String        _bodyClass              = ""; // class to add to body
     String        _title                  = FPSTR(S_brand); // app title -  default WiFiManager
 
@@ -643,6 +1157,72 @@ public:
 protected:
 
     boolean       _autoforcerescan        = false;  // automatically force rescan if scan networks is 0, ignoring cache
+    boolean       _scanTargeted           = false;  // last scan was targeted (partial results), force a full rescan for the portal
+    wm_scan_opts_t _scanOpts;                       // scan options, passive, dwell, hidden
+    unsigned long _scanDuration           = 0;      // ms duration of last completed scan
+    boolean       _scanRunning            = false;  // async scan in progress, polled by scheduler
+    boolean       _bgscan                 = false;  // background scan scheduler enabled
+    unsigned long _bgscanInterval         = 10000;  // ms background scan interval while clients are active
+    unsigned long _bgscanMaxInterval      = 120000; // ms max background scan interval when idle (backoff)
+    unsigned long _bgscanBackoff          = 0;      // ms current background scan interval
+    unsigned long _bgscanNext             = 0;      // ms next background scan due
+    boolean       _connecting             = false;  // sta connect in progress, no scans
+    boolean       _otaInProgress          = false;  // ota upload in progress, no scans
+
+    boolean       _fastConnect            = false;  // connect with cached bssid and channel first
+    unsigned long _fastConnectTimeout     = 10000;  // ms fast connect attempt timeout before falling back
+    wm_rtc_t      _rtc;                             // rtc cache mirror
+    boolean       _rtcLoaded              = false;  // rtc cache read
+    boolean       _fastBoot               = false;  // skip already applied wifi setup in autoconnect
+    boolean       _scanGate               = false;  // autoconnect only connects to networks seen in a scan
+    wm_fastconx_t _saveConx               = {};     // portal save, bssid and channel from the portal scan, channel 0 for none
+    unsigned long _saveStart              = 0;      // ms portal wifi save
+    unsigned long _saveConnectMs          = 0;      // ms portal wifi save to connected
+    boolean       _storeBegun             = false;  // flash store mounted
+    boolean       _dhcpCache              = false;  // reuse dhcp assigned ip config
+    uint16_t      _dhcpCacheMaxUses       = 50;     // connects on a cached config before a full dhcp refresh
+    wm_ipcache_stats_t _ipcStats;                   // ip cache stats
+    volatile uint32_t _ipcConfirm         = 0;      // ms dhcp restarted to confirm the cached ip config, 0 none
+    volatile bool _ipcDirty               = false;  // ip cache changed, flash write pending
+    #ifdef ESP32
+    volatile bool _ipcLease               = false;  // lease copied from the got ip event, compared in dhcpCacheProcess
+    volatile uint32_t _ipcLeaseIp         = 0;
+    volatile uint32_t _ipcLeaseGw         = 0;
+    volatile uint32_t _ipcLeaseSn         = 0;
+    #endif
+    boolean       _credStore              = false;  // use credential store in autoconnect, add portal saves
+    unsigned long _credTimeout            = 10000;  // ms connect timeout per stored network
+    std::unique_ptr<wm_credstore_t> _creds;         // credential store, loaded on demand
+    wm_wait_stats_t _waitStats[WM_WAIT_MAX];        // readiness wait stats
+    unsigned long _portalStartMs          = 0;      // ms portal start call, 0 when not started
+    unsigned long _portalReadyMs          = 0;      // ms from portal start to first request served
+    boolean       _reconnPolicy           = false;  // managed reconnect with backoff, sdk autoreconnect off
+    unsigned long _reconnBase             = 1000;   // ms first reconnect interval
+    unsigned long _reconnMax              = 300000; // ms max reconnect interval
+    uint8_t       _reconnJitter           = 25;     // percent random spread of each interval
+    unsigned long _reconnOutage           = 0;      // ms outage budget before starting the portal, 0 never
+    unsigned long _reconnDown             = 0;      // ms current outage start, 0 when connected
+    unsigned long _reconnLast             = 0;      // ms last attempt end or outage start
+    unsigned long _reconnAttempt          = 0;      // ms start of the attempt in progress, 0 none
+    unsigned long _reconnInterval         = 0;      // ms current backoff interval, before jitter
+    wm_reconnect_stats_t _reconnStats;              // reconnect policy counters
+    wm_async_state_t _asyncState          = WM_ASYNC_IDLE; // autoConnectAsync state
+    uint8_t       _asyncRetry             = 0;      // autoConnectAsync attempt, 0 for fast connect
+    unsigned long _asyncTimer             = 0;      // ms attempt or retry wait start
+    String        _asyncApName            = "";     // portal fallback ap name
+    String        _asyncApPassword        = "";     // portal fallback ap password
+    wm_conx_timeline_t _conxTimeline[WM_CONX_HISTORY]; // connect attempt history ring
+    uint8_t       _conxTimelineIdx        = 0;      // next history slot
+    uint8_t       _conxTimelineCount      = 0;      // history entries
+    wm_conx_timeline_t *_conxCur          = nullptr; // attempt being recorded, written from events
+    #ifdef ESP8266
+    WiFiEventHandler _staConnectedHandler;          // timeline events
+    WiFiEventHandler _staGotIPHandler;
+    WiFiEventHandler _staDisconnectedHandler;
+    #endif
+    #ifdef ESP32
+    Preferences   _prefs;                           // nvs namespace for flash store
+    #endif
     
     boolean       _disableIpFields        = false; // modify function of setShow_X_Fields(false), forces ip fields off instead of default show if set, eg. _staShowStaticFields=-1
 
@@ -654,7 +1234,7 @@ protected:
     void          _begin();
     void          _end();
 
-    void          setupConfigPortal();
+    void          setupConfigPortal(bool loadParams = true);
     bool          shutdownConfigPortal();
     bool          setupHostname(bool restart);
     
@@ -667,10 +1247,41 @@ protected:
     void          setupDNSD();
     void          setupHTTPServer();
 
-    uint8_t       connectWifi(String ssid, String pass, bool connect = true);
+    uint8_t       connectWifi(String ssid, String pass, bool connect = true, unsigned long timeout = 0, bool persist = true);
+    uint8_t       connectCredentials();
+    bool          connectScanGate(const String &ssid);
+    void          asyncConnectBegin();
+    void          asyncConnectProcess();
+    void          asyncConnectFallback();
+    void          asyncConnectState(wm_async_state_t state);
+    boolean       startConfigPortalNonBlocking(const String &apName, const String &apPassword);
+    void          reconnectProcess();
+    unsigned long reconnectJitter(unsigned long interval);
     bool          setSTAConfig();
     bool          wifiConnectDefault();
-    bool          wifiConnectNew(String ssid, String pass,bool connect = true);
+    bool          wifiConnectNew(String ssid, String pass,bool connect = true, bool persist = true);
+    bool          wifiConnectFast(String ssid, String pass, bool persist = true);
+    bool          wifiConnectSaved(String ssid, String pass);
+    bool          fastConnectLoad();
+    void          fastConnectSave();
+    void          fastConnectClear();
+    uint32_t      fastBootFingerprint();
+    bool          WiFi_countryApplied();
+    bool          dhcpCacheLoad();
+    bool          dhcpCacheApply(const String &ssid);
+    void          dhcpCacheUpdate(unsigned long connectms);
+    void          dhcpCacheClear();
+    bool          dhcpCacheRecord(unsigned long dhcpms);
+    void          dhcpCacheLease(uint32_t ip, uint32_t gw, uint32_t sn);
+    void          dhcpCacheProcess();
+    bool          credLoad();
+    bool          credSave();
+    int           credFind(const char* ssid);
+    bool          credAdd(const char* ssid, const char* pass, bool success);
+    void          credMigrate();
+    void          credClear();
+    void          conxTimelineStart(uint8_t attempt);
+    void          conxTimelineEnd(uint8_t result);
 
     uint8_t       waitForConnectResult();
     uint8_t       waitForConnectResult(uint32_t timeout);
@@ -683,6 +1294,9 @@ protected:
     void          HTTPSend(const String &content);
     void          handleRoot();
     void          handleWifi(boolean scan);
+    void          handleWifiScan();
+    void          handleConxLog();
+    void          handleConfigApi();
     void          handleWifiSave();
     void          handleInfo();
     void          handleReset();
@@ -696,6 +1310,9 @@ protected:
     void          handleRequest();
     void          handleParamSave();
     void          doParamSave();
+    bool          paramSet(WiFiManagerParameter *p, const String &value);
+    void          paramsSaved();
+    String        getConfigJson();
 
     boolean       captivePortal();
     boolean       configPortalHasTimeout();
@@ -717,15 +1334,39 @@ protected:
     uint8_t       WiFi_softap_num_stations();
     bool          WiFi_hasAutoConnect();
     void          WiFi_autoReconnect();
+    void          WiFi_registerEvents();
+    uint8_t       WiFi_connectStatus();
+    void          WiFi_connectStatusReset();
+    bool          waitFor(std::function<bool()> ready, unsigned long timeout, wm_wait_id_t id);
+    bool          apReady();
     String        WiFi_SSID(bool persistent = true) const;
     String        WiFi_psk(bool persistent = true) const;
     bool          WiFi_scanNetworks();
     bool          WiFi_scanNetworks(bool force,bool async);
     bool          WiFi_scanNetworks(unsigned int cachetime,bool async);
     bool          WiFi_scanNetworks(unsigned int cachetime);
+    bool          WiFi_scanNetworks(const wm_scan_opts_t &opts);
+    int16_t       WiFi_scanStart(const wm_scan_opts_t &opts, uint8_t channel, bool async);
+    int           WiFi_scanFind(const String &ssid);
+    bool          WiFi_scanHasHidden();
+    int           WiFi_scanForSSID(const String &ssid, uint16_t channels = 0);
     void          WiFi_scanComplete(int networksFound);
+    bool          WiFi_scanStartAsync();
+    void          WiFi_scanPoll();
+    void          WiFi_scanRequest(bool force);
+    void          WiFi_scanWait();
+    void          backgroundScan();
     bool          WiFiSetCountry();
 
+    // rtc and flash persistence
+    bool          rtcLoad();
+    bool          rtcSave();
+    bool          storeBegin();
+    bool          storeRead(const char *key, void *data, size_t len, uint16_t ver = 0);
+    bool          storeWrite(const char *key, const void *data, size_t len, uint16_t ver = 0);
+    bool          storeRemove(const char *key);
+    bool          storeKeyAllowed(const char *key);
+
     #ifdef ESP32
 
     // check for arduino or system event system, handle esp32 arduino v2 and IDF
@@ -745,8 +1386,13 @@ protected:
             #define WM_DISCONWORKAROUND
         #endif
 
+        #if ESP_ARDUINO_VERSION < ESP_ARDUINO_VERSION_VAL(2, 0, 6)
+            #define WM_NOSCANFILTER
+        #endif
+
     #else 
         #define WM_NOCOUNTRY
+        #define WM_NOSCANFILTER
     #endif
 
     #ifdef WM_NOCOUNTRY
@@ -762,9 +1408,14 @@ protected:
     #endif
 
     // output helpers
-    String        getParamOut();
+    String        getParamOut(const String &section = "");
+    String        getParamSectionsOut();
+    bool          paramInSection(const WiFiManagerParameter *p, const String &section);
+    bool          paramValid(const WiFiManagerParameter *p);
+    bool          paramSectionExists(const String &section);
     String        getIpForm(String id, String title, String value);
-    String        getScanItemOut();
+    String        getScanItemOut(int page = -1, const String &query = "", int *next = nullptr);
+    void          getScanIndices(std::vector<int> &indices, const String &query = "");
     String        getStaticOut();
     String        getHTTPHead(String title, String classes = "");
     String        getHTTPEnd();
@@ -799,6 +1450,28 @@ protected:
     int         _paramsCount          = 0;
     int         _max_params;
     WiFiManagerParameter** _params    = NULL;
+    std::unique_ptr<uint8_t[]> _paramArena; // storage for owned parameters, reserveParameters
+    size_t      _paramArenaSize       = 0;
+    size_t      _paramArenaUsed       = 0;
+    std::vector<WiFiManagerParameter*> _paramsOwned; // parameters added by value, destroyed with wifimanager
+    boolean     _paramStore           = false; // persist parameter values in the flash store
+    uint16_t    _paramStoreVer        = 0;     // parameter record version
+    int         _paramsLoaded         = 0;     // parameters loaded from the store, in add order
+    int         _paramsChanged        = 0;     // parameters changed by the last save
+    std::unique_ptr<uint16_t[]> _paramIndex; // open addressing id hash index, param index + 1, 0 empty
+    uint16_t    _paramIndexSize       = 0;     // slots, power of 2
+    boolean     _saveParamsOnChange   = false; // skip save params callback when nothing changed
+    boolean     _configApi            = false; // /api/config endpoint
+
+    void          paramStoreKey(const WiFiManagerParameter *p, char *key);
+    uint32_t      paramCrc(const WiFiManagerParameter *p);
+    int           paramIndexFind(const char *id);
+    void          paramIndexAdd(int i);
+
+    void*         paramAlloc(size_t size, size_t align);
+    void          paramAdopt(WiFiManagerParameter *p);
+    void          paramFree(WiFiManagerParameter *p);
+    bool          paramsResize(int max);
 
     boolean _debug  = true;
     String _debugPrefix = FPSTR(S_debugPrefix);
@@ -849,9 +1522,11 @@ protected:
     std::function<void()> _presavewificallback;
     std::function<void()> _presaveparamscallback;
     std::function<void()> _saveparamscallback;
+    std::function<void(WiFiManagerParameter*)> _paramchangedcallback;
     std::function<void()> _resetcallback;
     std::function<void()> _preotaupdatecallback;
     std::function<void()> _configportaltimeoutcallback;
+    std::function<void(wm_async_state_t)> _asyncconnectcallback;
 
     template <class T>
     auto optionalIPFromString(T *obj, const char *s) -> decltype(  obj->fromString(s)  ) {
@@ -864,6 +1539,27 @@ protected:
 
 };
 
+/**
+ * add a parameter by value, moved into the parameter arena, or the heap when the arena is full
+ * its value buffer is moved into the arena too, wifimanager destroys it
+ */
+template<typename P, typename std::enable_if<std::is_base_of<WiFiManagerParameter,typename std::remove_reference<P>::type>::value && !std::is_lvalue_reference<P>::value,int>::type>
+typename std::remove_reference<P>::type* WiFiManager::addParameter(P &&param){
+  typedef typename std::remove_reference<P>::type PT;
+  void *mem = paramAlloc(sizeof(PT), alignof(PT));
+  PT *p = mem ? new (mem) PT(std::move(param)) : new (std::nothrow) PT(std::move(param));
+  if(!p) return NULL;
+  WiFiManagerParameter *base = p;
+  base->_storage = mem ? WM_PARAM_ARENA : WM_PARAM_HEAP;
+  paramAdopt(base);
+  if(!addParameter(base)){
+    paramFree(base);
+    return NULL;
+  }
+  _paramsOwned.push_back(base);
+  return p;
+}
+
 #endif
 
 #endif
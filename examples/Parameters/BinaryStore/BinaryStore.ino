@@ -0,0 +1,98 @@
+/**
+ * Parameters persisted by WiFiManager as binary records, no json or save callback code
+ * values are loaded before autoConnect and the portal, only changed parameters are written on save
+ *
+ * build with -DWM_FLASHSTORE, esp8266 stores in LittleFS (must be formatted), esp32 in NVS
+ *
+ * the benchmark compares a save of one changed parameter against the usual
+ * ArduinoJson config.json rewrite from the SPIFFS/LittleFS examples, with the same values
+ */
+#include <WiFiManager.h> // https://github.com/tzapu/WiFiManager
+#include <LittleFS.h>
+#include <ArduinoJson.h> // https://github.com/bblanchon/ArduinoJson, benchmark only
+
+#ifndef WM_FLASHSTORE
+#warning "build with -DWM_FLASHSTORE to persist parameters"
+#endif
+
+WiFiManager wm;
+
+WiFiManagerParameterString<40> mqtt_server("server", "mqtt server", "mqtt.example.com");
+WiFiManagerParameterT<int>     mqtt_port("port", "mqtt port", 1883, 1, 65535);
+WiFiManagerParameterString<34> api_token("apikey", "api token", "YOUR_API_TOKEN");
+WiFiManagerParameterT<float>   temp_offset("offset", "temperature offset", 0.0, -10.0, 10.0);
+WiFiManagerParameterT<bool>    use_tls("tls", "use tls", false);
+
+void saveJson(){
+  DynamicJsonDocument json(512);
+  json["mqtt_server"] = mqtt_server.getValue();
+  json["mqtt_port"]   = mqtt_port.get();
+  json["api_token"]   = api_token.getValue();
+  json["offset"]      = temp_offset.get();
+  json["tls"]         = use_tls.get();
+  File configFile = LittleFS.open("/config.json", "w");
+  serializeJson(json, configFile);
+  configFile.close();
+}
+
+void loadJson(){
+  File configFile = LittleFS.open("/config.json", "r");
+  DynamicJsonDocument json(512);
+  deserializeJson(json, configFile);
+  configFile.close();
+  mqtt_server.setValue(json["mqtt_server"].as<const char*>(), 40);
+  mqtt_port.set(json["mqtt_port"].as<int>());
+  api_token.setValue(json["api_token"].as<const char*>(), 34);
+  temp_offset.set(json["offset"].as<float>());
+  use_tls.set(json["tls"].as<bool>());
+}
+
+void benchmark(){
+  Serial.println("benchmark, 10 saves with one changed parameter");
+  LittleFS.begin();
+
+  uint32_t heap = ESP.getFreeHeap();
+  unsigned long start = micros();
+  for(int i = 0; i < 10; i++){
+    mqtt_port.set(1000 + i);
+    saveJson();
+  }
+  Serial.printf("json save:   %lu us, heap used %d\n", (micros() - start) / 10, (int)(heap - ESP.getFreeHeap()));
+
+  start = micros();
+  for(int i = 0; i < 10; i++){
+    mqtt_port.set(2000 + i);
+    wm.saveParameters();
+  }
+  Serial.printf("binary save: %lu us\n", (micros() - start) / 10);
+
+  start = micros();
+  loadJson();
+  Serial.printf("json load:   %lu us\n", micros() - start);
+  mqtt_port.set(1883);
+  wm.saveParameters();
+}
+
+void setup() {
+  WiFi.mode(WIFI_STA); // explicitly set mode, esp defaults to STA+AP
+  Serial.begin(115200);
+
+  wm.setParamStore(true, 1); // bump the version when parameters change meaning
+  wm.addParameter(&mqtt_server);
+  wm.addParameter(&mqtt_port);
+  wm.addParameter(&api_token);
+  wm.addParameter(&temp_offset);
+  wm.addParameter(&use_tls);
+
+  // stored values are loaded here, and written when changed in the portal
+  if(!wm.autoConnect("AutoConnectAP")){
+    Serial.println("failed to connect");
+  }
+
+  Serial.printf("server: %s port: %d offset: %.2f tls: %d\n", mqtt_server.getValue(), mqtt_port.get(), temp_offset.get(), use_tls.get());
+
+  benchmark();
+}
+
+void loop() {
+}
@@ -50,6 +50,9 @@ const uint8_t _nummenutokens = (sizeof(_menutokens) / sizeof(PGM_P));
 const char R_root[]               PROGMEM = "/";
 const char R_wifi[]               PROGMEM = "/wifi";
 const char R_wifinoscan[]         PROGMEM = "/0wifi";
+const char R_wifiscan[]           PROGMEM = "/wifiscan";
+const char R_conxlog[]            PROGMEM = "/conxlog";
+const char R_apiconfig[]          PROGMEM = "/api/config";
 const char R_wifisave[]           PROGMEM = "/wifisave";
 const char R_info[]               PROGMEM = "/info";
 const char R_param[]              PROGMEM = "/param";
@@ -104,13 +107,16 @@ const char T_q[]                  PROGMEM = "{q}"; // @token q
 const char T_r[]                  PROGMEM = "{r}"; // @token r
 const char T_R[]                  PROGMEM = "{R}"; // @token R
 const char T_h[]                  PROGMEM = "{h}"; // @token h
+const char T_o[]                  PROGMEM = "{o}"; // @token o
 
 // http
 const char HTTP_HEAD_CL[]         PROGMEM = "Content-Length";
 const char HTTP_HEAD_CT[]         PROGMEM = "text/html";
 const char HTTP_HEAD_CT2[]        PROGMEM = "text/plain";
+const char HTTP_HEAD_CTJSON[]     PROGMEM = "application/json";
 const char HTTP_HEAD_CORS[]       PROGMEM = "Access-Control-Allow-Origin";
 const char HTTP_HEAD_CORS_ALLOW_ALL[]  PROGMEM = "*";
+const char HTTP_HEAD_PAGENEXT[]   PROGMEM = "X-Page-Next";
 
 const char * const WIFI_STA_STATUS[] PROGMEM
 {
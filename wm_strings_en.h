@@ -70,8 +70,17 @@ const char HTTP_FORM_END[]         PROGMEM = "<br/><br/><button type='submit'>Sa
 const char HTTP_FORM_LABEL[]       PROGMEM = "<label for='{i}'>{t}</label>";
 const char HTTP_FORM_PARAM_HEAD[]  PROGMEM = "<hr><br/>";
 const char HTTP_FORM_PARAM[]       PROGMEM = "<br/><input id='{i}' name='{n}' maxlength='{l}' value='{v}' {c}>\n"; // do not remove newline!
+const char HTTP_FORM_SELECT[]      PROGMEM = "<br/><select id='{i}' name='{n}' {c}>{o}</select>\n";
+const char HTTP_FORM_OPTION[]      PROGMEM = "<option value='{v}'{c}>{t}</option>";
+const char HTTP_FORM_SECTION[]     PROGMEM = "<h3>{t}</h3><input type='hidden' name='section' value='{v}'>";
+const char HTTP_PARAM_SECTION[]    PROGMEM = "<form action='/param' method='get'><button name='section' value='{v}'>{t}</button></form><br/>\n"; // parameter section sub-page
 
 const char HTTP_SCAN_LINK[]        PROGMEM = "<br/><form action='/wifi?refresh=1' method='POST'><button name='refresh' value='1'>Refresh</button></form>";
+const char HTTP_SCAN_JS[]          PROGMEM = "<script>function w(p,r){var x=new XMLHttpRequest(),l=document.getElementById('sl'),b=document.getElementById('sm');"
+"x.onload=function(){if(r)l.innerHTML='';l.insertAdjacentHTML('beforeend',x.responseText);var n=x.getResponseHeader('X-Page-Next');b.setAttribute('data-p',n);b.className=n?'':'h';};"
+"x.open('GET','/wifiscan?page='+p+'&q='+encodeURIComponent(document.getElementById('q').value));x.send();}</script>"; // scan list paging
+const char HTTP_SCAN_SEARCH[]      PROGMEM = "<input id='q' placeholder='Search' autocorrect='off' autocapitalize='none' oninput='w(0,1)'>";
+const char HTTP_SCAN_MORE[]        PROGMEM = "<button id='sm' type='button' class='{h}' data-p='{v}' onclick='w(this.getAttribute(\"data-p\"))'>More</button>"; // {v} = next page
 const char HTTP_SAVED[]            PROGMEM = "<div class='msg'>Saving Credentials<br/>Trying to connect ESP to network.<br />If it fails reconnect to AP to try again</div>";
 const char HTTP_PARAMSAVED[]       PROGMEM = "<div class='msg S'>Saved<br/></div>";
 const char HTTP_END[]              PROGMEM = "</div></body></html>";
@@ -214,6 +223,7 @@ const char HTTP_INFO_dnss[]       PROGMEM = "<dt>DNS Server</dt><dd>{1}</dd>";
 const char HTTP_INFO_host[]       PROGMEM = "<dt>Hostname</dt><dd>{1}</dd>";
 const char HTTP_INFO_stamac[]     PROGMEM = "<dt>Station MAC</dt><dd>{1}</dd>";
 const char HTTP_INFO_conx[]       PROGMEM = "<dt>Connected</dt><dd>{1}</dd>";
+const char HTTP_INFO_conxtime[]   PROGMEM = "<dt>Last connect</dt><dd>{1}</dd>";
 const char HTTP_INFO_autoconx[]   PROGMEM = "<dt>Autoconnect</dt><dd>{1}</dd>";
 
 const char HTTP_INFO_aboutver[]     PROGMEM = "<dt>WiFiManager</dt><dd>{1}</dd>";
@@ -256,6 +266,7 @@ const char S_uri[]                PROGMEM = "URI: ";
 const char S_method[]             PROGMEM = "\nMethod: ";
 const char S_args[]               PROGMEM = "\nArguments: ";
 const char S_parampre[]           PROGMEM = "param_";
+const char S_section[]            PROGMEM = "section";
 
 // debug strings
 const char D_HR[]                 PROGMEM = "--------------------";